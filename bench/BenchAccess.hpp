@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Minesweeper.hpp>
+#include <Sprites.hpp>
+#include <ThreadPool.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+// the benchmarks' way into private engine and sprite steps; Minesweeper and Sprites befriend it
+class BenchAccess
+{
+public:
+  static void initMinefield(Minesweeper &game, const uint64_t seed, const int row, const int col)
+  {
+    game.seed = seed;
+    game.initMinefield(row, col);
+  }
+
+  static void revealCell(Minesweeper &game, const int row, const int col)
+  {
+    game.revealedCells.clear();
+    game.revealCell(row, col);
+  }
+
+  // an empty cacheDir draws every sprite, on pool's workers when there is one; returns once they're all drawn
+  static std::unique_ptr<Sprites> makeSprites(const std::filesystem::path &cacheDir = {}, ThreadPool *pool = nullptr)
+  {
+    auto sprites = std::unique_ptr<Sprites>(new Sprites(cacheDir, pool));
+    sprites->waitUntilBaked();
+    return sprites;
+  }
+};
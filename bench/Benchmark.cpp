@@ -0,0 +1,223 @@
+#include <Benchmark.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+namespace
+{
+struct Benchmark
+{
+  std::string name;
+  Function function;
+  std::vector<std::vector<int64_t>> argSets;
+};
+
+struct Result
+{
+  std::string name;
+  int64_t numIterations;
+  double nsPerIteration;
+  double itemsPerSecond;
+};
+
+// enough to make timer resolution and the per-iteration loop overhead irrelevant
+constexpr int64_t MAX_ITERATIONS = int64_t(1) << 30;
+
+// stops benchmarks whose paused setup dwarfs the timed part from running for minutes
+constexpr double MAX_WALL_TIME_FACTOR = 20;
+
+std::vector<Benchmark> &getBenchmarks()
+{
+  static std::vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+
+std::string toRunName(const std::string &name, const std::vector<int64_t> &args)
+{
+  std::string runName = name;
+  for (const auto arg : args)
+  {
+    runName += "/" + std::to_string(arg);
+  }
+  return runName;
+}
+
+Result run(const std::string &name, const Function &function, const std::vector<int64_t> &args, const double minTime)
+{
+  for (int64_t numIterations = 1;; numIterations *= 2)
+  {
+    State state(args, numIterations);
+    const auto start = std::chrono::steady_clock::now();
+    function(state);
+    const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (state.getSeconds() >= minTime || wallSeconds >= MAX_WALL_TIME_FACTOR * minTime ||
+        numIterations >= MAX_ITERATIONS)
+    {
+      const double seconds = state.getSeconds();
+      return {
+          toRunName(name, args),
+          numIterations,
+          seconds * 1e9 / numIterations,
+          seconds > 0 ? state.getItemsPerIteration() * numIterations / seconds : 0};
+    }
+  }
+}
+
+void printJson(const std::vector<Result> &results)
+{
+  std::cout << "{\n";
+  std::cout << "  \"context\": {\n";
+  std::cout << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+  std::cout << "    \"build_type\": \"release\"\n";
+#else
+  std::cout << "    \"build_type\": \"debug\"\n";
+#endif
+  std::cout << "  },\n";
+  std::cout << "  \"benchmarks\": [\n";
+  for (std::size_t i = 0; i < results.size(); ++i)
+  {
+    const auto &result = results[i];
+    std::cout << "    {\"name\": \"" << result.name << "\", \"iterations\": " << result.numIterations
+              << ", \"real_time\": " << result.nsPerIteration << ", \"time_unit\": \"ns\"";
+    if (result.itemsPerSecond > 0)
+    {
+      std::cout << ", \"items_per_second\": " << result.itemsPerSecond;
+    }
+    std::cout << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  std::cout << "  ]\n";
+  std::cout << "}\n";
+}
+
+void printText(const Result &result)
+{
+  std::cout << std::left << std::setw(48) << result.name << std::right << std::setw(16) << std::fixed
+            << std::setprecision(1) << result.nsPerIteration << " ns" << std::setw(12) << result.numIterations;
+  if (result.itemsPerSecond > 0)
+  {
+    std::cout << std::setw(14) << std::setprecision(3) << result.itemsPerSecond / 1e6 << " M items/s";
+  }
+  std::cout << std::endl;
+}
+} // namespace
+
+State::State(const std::vector<int64_t> &a, const int64_t n) : args(a), numIterations(n), numIterationsLeft(n) {}
+
+bool State::keepRunning()
+{
+  if (!isTiming && numIterationsLeft == numIterations)
+  {
+    resumeTiming();
+  }
+
+  if (numIterationsLeft-- > 0)
+  {
+    return true;
+  }
+
+  pauseTiming();
+  return false;
+}
+
+void State::pauseTiming()
+{
+  if (isTiming)
+  {
+    elapsed += Clock::now() - start;
+    isTiming = false;
+  }
+}
+
+void State::resumeTiming()
+{
+  if (!isTiming)
+  {
+    isTiming = true;
+    start = Clock::now();
+  }
+}
+
+void registerBenchmark(const std::string &name, Function function, const std::vector<std::vector<int64_t>> &argSets)
+{
+  // no argument sets still means one run
+  getBenchmarks().push_back(
+      {name, std::move(function), argSets.empty() ? std::vector<std::vector<int64_t>>{{}} : argSets});
+}
+
+int runBenchmarks(const int argc, char **argv)
+{
+  std::string filter;
+  double minTime = 0.25;
+  bool isJson = true;
+
+  try
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      const std::string key = argv[i];
+      if (i + 1 >= argc)
+      {
+        throw std::runtime_error("missing value for " + key);
+      }
+      const std::string value = argv[++i];
+
+      if (key == "--filter")
+      {
+        filter = value;
+      }
+      else if (key == "--min-time")
+      {
+        minTime = std::stod(value);
+      }
+      else if (key == "--format" && (value == "json" || value == "text"))
+      {
+        isJson = value == "json";
+      }
+      else
+      {
+        throw std::runtime_error("unknown option " + key + " " + value);
+      }
+    }
+  }
+  catch (const std::exception &e)
+  {
+    std::cerr << "minesweeper_bench: " << e.what() << "\n"
+              << "usage: minesweeper_bench [--filter SUBSTRING] [--min-time SECONDS] [--format json|text]\n";
+    return 1;
+  }
+
+  std::vector<Result> results;
+  for (const auto &benchmark : getBenchmarks())
+  {
+    for (const auto &args : benchmark.argSets)
+    {
+      if (toRunName(benchmark.name, args).find(filter) == std::string::npos)
+      {
+        continue;
+      }
+
+      results.push_back(run(benchmark.name, benchmark.function, args, minTime));
+      if (!isJson)
+      {
+        printText(results.back());
+      }
+    }
+  }
+
+  if (isJson)
+  {
+    printJson(results);
+  }
+  return 0;
+}
+} // namespace bench
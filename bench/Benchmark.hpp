@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Minimal benchmark harness: each registered benchmark runs once per argument set, with the iteration count doubled
+// until a run lasts at least the minimum time, and results are written as JSON (or a text table) so runs can be diffed
+// between releases.
+namespace bench
+{
+class State
+{
+public:
+  State(const std::vector<int64_t> &args, const int64_t numIterations);
+
+  int64_t getArg(const std::size_t i) const { return args.at(i); }
+  int64_t getNumIterations() const { return numIterations; }
+
+  // while (state.keepRunning()) { ... } runs the body getNumIterations() times, timing it
+  bool keepRunning();
+  // excludes per-iteration setup from the measurement
+  void pauseTiming();
+  void resumeTiming();
+
+  // work done per iteration, reported as a rate alongside the time
+  void setItemsPerIteration(const int64_t newVal) { itemsPerIteration = newVal; }
+
+  double getSeconds() const { return std::chrono::duration<double>(elapsed).count(); }
+  int64_t getItemsPerIteration() const { return itemsPerIteration; }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  std::vector<int64_t> args;
+  int64_t numIterations;
+  int64_t numIterationsLeft;
+  int64_t itemsPerIteration = 0;
+  Clock::duration elapsed{};
+  Clock::time_point start;
+  bool isTiming = false;
+};
+
+using Function = std::function<void(State &)>;
+
+// name/arg0/arg1/... becomes the reported name of each run
+void registerBenchmark(const std::string &name, Function function, const std::vector<std::vector<int64_t>> &argSets);
+
+// --filter SUBSTRING, --min-time SECONDS, --format json|text
+int runBenchmarks(const int argc, char **argv);
+
+void registerEngineBenchmarks();
+void registerRasterBenchmarks();
+} // namespace bench
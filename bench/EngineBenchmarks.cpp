@@ -0,0 +1,183 @@
+#include <BenchAccess.hpp>
+#include <Benchmark.hpp>
+#include <InfiniteMinesweeper.hpp>
+#include <Minesweeper.hpp>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace
+{
+constexpr uint64_t SEED = 1;
+
+// width, height, mine density in percent
+const std::vector<std::vector<int64_t>> BOARDS = {
+    {9, 9, 12},
+    {30, 16, 20},
+    {100, 100, 5},
+    {100, 100, 20},
+    {1000, 1000, 5},
+    {1000, 1000, 20},
+};
+
+// mine density in percent; at 5 the first click runs into InfiniteMinesweeper::MAX_REVEALED_CELLS_PER_CLICK
+const std::vector<std::vector<int64_t>> INFINITE_DENSITIES = {{5}, {12}, {20}};
+
+struct Board
+{
+  int width;
+  int height;
+  int numMines;
+};
+
+Board getBoard(const bench::State &state)
+{
+  const int width = static_cast<int>(state.getArg(0));
+  const int height = static_cast<int>(state.getArg(1));
+  return {width, height, static_cast<int>(int64_t(width) * height * state.getArg(2) / 100)};
+}
+
+void initMinefield(bench::State &state)
+{
+  const auto board = getBoard(state);
+  Minesweeper game(board.width, board.height, board.numMines);
+
+  uint64_t seed = SEED;
+  while (state.keepRunning())
+  {
+    BenchAccess::initMinefield(game, seed++, board.height / 2, board.width / 2);
+  }
+  state.setItemsPerIteration(int64_t(board.width) * board.height);
+}
+
+void firstClick(bench::State &state)
+{
+  const auto board = getBoard(state);
+  Minesweeper game(board.width, board.height, board.numMines);
+
+  uint64_t seed = SEED;
+  while (state.keepRunning())
+  {
+    state.pauseTiming();
+    game.reset(seed++);
+    state.resumeTiming();
+
+    game.handleLeftClick(board.height / 2, board.width / 2);
+  }
+  state.setItemsPerIteration(int64_t(board.width) * board.height);
+}
+
+void floodFill(bench::State &state)
+{
+  const auto board = getBoard(state);
+  Minesweeper game(board.width, board.height, board.numMines);
+
+  // the first click's region on the same board every time, items are the cells it reveals
+  while (state.keepRunning())
+  {
+    state.pauseTiming();
+    BenchAccess::initMinefield(game, SEED, board.height / 2, board.width / 2);
+    state.resumeTiming();
+
+    BenchAccess::revealCell(game, board.height / 2, board.width / 2);
+  }
+  state.setItemsPerIteration(static_cast<int64_t>(game.getRevealedCells().size()));
+}
+
+void chords(bench::State &state)
+{
+  const auto board = getBoard(state);
+  Minesweeper prepared(board.width, board.height, board.numMines);
+  prepared.startGame(SEED, board.height / 2, board.width / 2);
+
+  // flag every mine bordering the opened region, then chord every number along its edge
+  const auto &minefield = prepared.getMinefield();
+  std::vector<std::pair<int, int>> numbers;
+  for (int row = 0; row < board.height; ++row)
+  {
+    for (int col = 0; col < board.width; ++col)
+    {
+      bool isNextToRevealed = false;
+      bool isNextToHidden = false;
+      for (int dRow = -1; dRow <= 1; ++dRow)
+      {
+        for (int dCol = -1; dCol <= 1; ++dCol)
+        {
+          const int r = row + dRow;
+          const int c = col + dCol;
+          if ((dRow != 0 || dCol != 0) && r >= 0 && c >= 0 && r < board.height && c < board.width)
+          {
+            isNextToRevealed |= !minefield[r * board.width + c].getIsHidden();
+            isNextToHidden |= minefield[r * board.width + c].getIsHidden();
+          }
+        }
+      }
+
+      const auto &cell = minefield[row * board.width + col];
+      if (cell.getIsHidden() && cell.getIsMine() && isNextToRevealed)
+      {
+        prepared.handleRightClick(row, col);
+      }
+      else if (!cell.getIsHidden() && cell.getNumAdjacentMines() > 0 && isNextToHidden)
+      {
+        numbers.push_back({row, col});
+      }
+    }
+  }
+
+  // Minesweeper is copy-constructible but not assignable
+  std::optional<Minesweeper> game;
+  while (state.keepRunning())
+  {
+    state.pauseTiming();
+    game.emplace(prepared);
+    state.resumeTiming();
+
+    for (const auto &[row, col] : numbers)
+    {
+      game->handleMiddleClick(row, col);
+    }
+  }
+  state.setItemsPerIteration(static_cast<int64_t>(numbers.size()));
+}
+
+void checkForGameWon(bench::State &state)
+{
+  const auto board = getBoard(state);
+  Minesweeper game(board.width, board.height, board.numMines);
+  game.startGame(SEED, board.height / 2, board.width / 2);
+
+  while (state.keepRunning())
+  {
+    game.checkForGameWon();
+  }
+}
+// the first click's region on the unbounded board, chunk generation and counting included
+void infiniteFirstClick(bench::State &state)
+{
+  const double density = state.getArg(0) / 100.0;
+
+  int64_t numRevealedCells = 0;
+  while (state.keepRunning())
+  {
+    state.pauseTiming();
+    InfiniteMinesweeper game(SEED, density);
+    state.resumeTiming();
+
+    game.handleLeftClick(0, 0);
+    numRevealedCells = game.getNumRevealedCells();
+  }
+  state.setItemsPerIteration(numRevealedCells);
+}
+} // namespace
+
+void bench::registerEngineBenchmarks()
+{
+  registerBenchmark("engine/init_minefield", initMinefield, BOARDS);
+  registerBenchmark("engine/first_click", firstClick, BOARDS);
+  registerBenchmark("engine/flood_fill", floodFill, BOARDS);
+  registerBenchmark("engine/chords", chords, BOARDS);
+  registerBenchmark("engine/check_for_game_won", checkForGameWon, BOARDS);
+  registerBenchmark("engine/infinite_first_click", infiniteFirstClick, INFINITE_DENSITIES);
+}
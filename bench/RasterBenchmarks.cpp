@@ -0,0 +1,258 @@
+#include <BenchAccess.hpp>
+#include <Benchmark.hpp>
+#include <Blitter.hpp>
+#include <HeaderArtist.hpp>
+#include <MinefieldArtist.hpp>
+#include <Minesweeper.hpp>
+#include <Rect.h>
+#include <Sprites.hpp>
+#include <ThreadPool.hpp>
+#include <config.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+constexpr uint64_t SEED = 1;
+
+// the window is sized once for the biggest board, since the artists read their layout from the global settings
+constexpr int MAX_GRID_SIZE = 64;
+
+// width, height, mine density in percent
+const std::vector<std::vector<int64_t>> BOARDS = {
+    {9, 9, 12},
+    {30, 16, 20},
+    {MAX_GRID_SIZE, MAX_GRID_SIZE, 20},
+};
+
+// square sprite sizes: smaller than a cell, the default cell, bigger than any cell
+const std::vector<std::vector<int64_t>> SPRITE_SIZES = {{16}, {config::DEFAULT_CELL_PIXEL_SIZE}, {256}};
+
+enum class BlitMode
+{
+  OPAQUE,
+  COLOR_KEY,
+  ALPHA,
+};
+
+constexpr uint32_t COLOR_KEY = config::Colors::BLACK;
+
+std::vector<uint32_t> makeFrameBuffer()
+{
+  return std::vector<uint32_t>(
+      config::getSettings().getGameWindowWidth() * config::getSettings().getGameWindowHeight(), config::Colors::GREY);
+}
+
+Minesweeper makeGame(const bench::State &state)
+{
+  const int width = static_cast<int>(state.getArg(0));
+  const int height = static_cast<int>(state.getArg(1));
+  Minesweeper game(width, height, static_cast<int>(int64_t(width) * height * state.getArg(2) / 100));
+  game.startGame(SEED, height / 2, width / 2);
+  return game;
+}
+
+void updateMinefield(bench::State &state)
+{
+  auto game = makeGame(state);
+  auto frameBuffer = makeFrameBuffer();
+  Sprites::getInstance();
+
+  std::vector<Rect> damage;
+  while (state.keepRunning())
+  {
+    game.markAllCellsDirty();
+    MinefieldArtist::updateMinefield(frameBuffer, config::getSettings().getCellPixelSize(), game, damage);
+    damage.clear();
+  }
+  state.setItemsPerIteration(int64_t(game.getGridWidth()) * game.getGridHeight());
+}
+
+// the biggest board with 1 to 16 drawing threads, the caller's included
+void updateMinefieldParallel(bench::State &state)
+{
+  auto game = makeGame(state);
+  auto frameBuffer = makeFrameBuffer();
+  Sprites::getInstance();
+
+  const int numThreads = static_cast<int>(state.getArg(3));
+  const auto pool = numThreads > 1 ? std::make_unique<ThreadPool>(numThreads - 1) : nullptr;
+
+  std::vector<Rect> damage;
+  while (state.keepRunning())
+  {
+    game.markAllCellsDirty();
+    MinefieldArtist::updateMinefield(frameBuffer, config::getSettings().getCellPixelSize(), game, damage, pool.get());
+    damage.clear();
+  }
+  state.setItemsPerIteration(int64_t(game.getGridWidth()) * game.getGridHeight());
+}
+
+void updateMinefieldIdle(bench::State &state)
+{
+  auto game = makeGame(state);
+  auto frameBuffer = makeFrameBuffer();
+  std::vector<Rect> damage;
+  MinefieldArtist::updateMinefield(frameBuffer, config::getSettings().getCellPixelSize(), game, damage);
+
+  // nothing changed since the last frame
+  while (state.keepRunning())
+  {
+    MinefieldArtist::updateMinefield(frameBuffer, config::getSettings().getCellPixelSize(), game, damage);
+  }
+}
+
+void updateHeader(bench::State &state)
+{
+  auto game = makeGame(state);
+  auto frameBuffer = makeFrameBuffer();
+  Sprites::getInstance();
+
+  // a fresh DrawnState every time, so every widget is redrawn
+  std::vector<Rect> damage;
+  while (state.keepRunning())
+  {
+    HeaderArtist::DrawnState drawn;
+    HeaderArtist::updateHeader(frameBuffer, config::getSettings().getGameWindowWidth(), game, drawn, damage);
+    damage.clear();
+  }
+}
+
+// a sprite with every alpha value, where every third pixel is the color key
+std::vector<uint32_t> makeSprite(const int size)
+{
+  std::vector<uint32_t> sprite(size * size);
+  for (int i = 0; i < size * size; ++i)
+  {
+    sprite[i] = i % 3 == 0 ? COLOR_KEY : static_cast<uint32_t>(i) * 2654435761u;
+  }
+  return sprite;
+}
+
+// what Sprites::copy did before Blitter: square sprites only, reading the settings on every row
+void blitLegacy(bench::State &state)
+{
+  const int size = static_cast<int>(state.getArg(0));
+  const auto sprite = makeSprite(size);
+  auto frameBuffer = makeFrameBuffer();
+
+  while (state.keepRunning())
+  {
+    for (int row = 0; row < size; ++row)
+    {
+      const auto first = sprite.begin() + row * size;
+      const auto result = frameBuffer.begin() +
+                          (row + config::FRAME_WIDTH) * config::getSettings().getGameWindowWidth() +
+                          config::FRAME_WIDTH;
+      std::copy_n(first, size, result);
+    }
+  }
+  state.setItemsPerIteration(int64_t(size) * size);
+}
+
+bench::Function makeBlitBenchmark(const BlitMode mode, const char *kernels)
+{
+  return [mode, kernels](bench::State &state)
+  {
+    const char *defaultKernels = Blitter::getKernelName();
+    Blitter::setKernels(kernels);
+
+    const int size = static_cast<int>(state.getArg(0));
+    const auto sprite = makeSprite(size);
+    const Blitter::Image image{sprite.data(), size, size, size};
+    auto frameBuffer = makeFrameBuffer();
+    const auto target = Blitter::makeTarget(frameBuffer, config::getSettings().getGameWindowWidth());
+
+    while (state.keepRunning())
+    {
+      switch (mode)
+      {
+      case BlitMode::OPAQUE:
+        Blitter::blitOpaque(image, target, config::FRAME_WIDTH, config::FRAME_WIDTH);
+        break;
+      case BlitMode::COLOR_KEY:
+        Blitter::blitColorKey(image, target, config::FRAME_WIDTH, config::FRAME_WIDTH, COLOR_KEY);
+        break;
+      case BlitMode::ALPHA:
+        Blitter::blitAlpha(image, target, config::FRAME_WIDTH, config::FRAME_WIDTH);
+        break;
+      }
+    }
+    state.setItemsPerIteration(int64_t(size) * size);
+
+    Blitter::setKernels(defaultKernels);
+  };
+}
+
+void spritesConstruct(bench::State &state)
+{
+  while (state.keepRunning())
+  {
+    BenchAccess::makeSprites();
+  }
+}
+
+// one task per sprite on a pool of that many workers, the way the game bakes them while it creates its windows
+void spritesConstructParallel(bench::State &state)
+{
+  ThreadPool pool(static_cast<int>(state.getArg(0)));
+  while (state.keepRunning())
+  {
+    BenchAccess::makeSprites({}, &pool);
+  }
+}
+
+// a warm on-disk cache, which maps the baked sprites instead of drawing them
+void spritesConstructCached(bench::State &state)
+{
+  const auto cacheDir = std::filesystem::temp_directory_path() / "minesweeper_bench_sprites";
+  BenchAccess::makeSprites(cacheDir);
+
+  while (state.keepRunning())
+  {
+    BenchAccess::makeSprites(cacheDir);
+  }
+
+  std::error_code error;
+  std::filesystem::remove_all(cacheDir, error);
+}
+} // namespace
+
+void bench::registerRasterBenchmarks()
+{
+  const int cellPixelSize = config::DEFAULT_CELL_PIXEL_SIZE;
+  config::getSettings().initializeWithoutFile(
+      2 * config::FRAME_WIDTH + MAX_GRID_SIZE * cellPixelSize,
+      config::INFO_PANEL_HEIGHT + 3 * config::FRAME_WIDTH + MAX_GRID_SIZE * cellPixelSize,
+      cellPixelSize);
+
+  registerBenchmark("raster/update_minefield", updateMinefield, BOARDS);
+  registerBenchmark(
+      "raster/update_minefield_parallel",
+      updateMinefieldParallel,
+      {{MAX_GRID_SIZE, MAX_GRID_SIZE, 20, 1},
+       {MAX_GRID_SIZE, MAX_GRID_SIZE, 20, 2},
+       {MAX_GRID_SIZE, MAX_GRID_SIZE, 20, 4},
+       {MAX_GRID_SIZE, MAX_GRID_SIZE, 20, 8},
+       {MAX_GRID_SIZE, MAX_GRID_SIZE, 20, 16}});
+  registerBenchmark("raster/update_minefield_idle", updateMinefieldIdle, BOARDS);
+  registerBenchmark("raster/update_header", updateHeader, BOARDS);
+  registerBenchmark("raster/blit_legacy", blitLegacy, SPRITE_SIZES);
+  for (const char *kernels : Blitter::getSupportedKernelNames())
+  {
+    registerBenchmark(
+        std::string("raster/blit_opaque/") + kernels, makeBlitBenchmark(BlitMode::OPAQUE, kernels), SPRITE_SIZES);
+    registerBenchmark(
+        std::string("raster/blit_color_key/") + kernels, makeBlitBenchmark(BlitMode::COLOR_KEY, kernels), SPRITE_SIZES);
+    registerBenchmark(
+        std::string("raster/blit_alpha/") + kernels, makeBlitBenchmark(BlitMode::ALPHA, kernels), SPRITE_SIZES);
+  }
+  registerBenchmark("raster/sprites_construct", spritesConstruct, {});
+  registerBenchmark("raster/sprites_construct_parallel", spritesConstructParallel, {{1}, {2}, {4}, {8}});
+  registerBenchmark("raster/sprites_construct_cached", spritesConstructCached, {});
+}
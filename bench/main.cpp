@@ -0,0 +1,8 @@
+#include <Benchmark.hpp>
+
+int main(int argc, char **argv)
+{
+  bench::registerEngineBenchmarks();
+  bench::registerRasterBenchmarks();
+  return bench::runBenchmarks(argc, argv);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Copies rectangles of 32-bit pixels (the frame buffer's RGBA8888, alpha in the low byte) between buffers of any row
+// stride, clipped to the target. Rows go through SSE2/AVX2 kernels picked at runtime from the CPU's features, with a
+// scalar fallback elsewhere.
+class Blitter
+{
+public:
+  // rows are stride pixels apart, so an image can be a sub-rect of a bigger buffer
+  struct Image
+  {
+    const uint32_t *pixels;
+    int width;
+    int height;
+    int stride;
+  };
+
+  struct Target
+  {
+    uint32_t *pixels;
+    int width;
+    int height;
+    int stride;
+  };
+
+  // the whole of a buffer width pixels wide
+  static Target makeTarget(std::vector<uint32_t> &buff, const int width);
+
+  // the source's top-left lands on (x, y) of the target; whatever falls outside the target is skipped
+  static void blitOpaque(const Image &source, const Target &target, const int x, const int y);
+  // leaves the target alone wherever the source equals colorKey
+  static void
+  blitColorKey(const Image &source, const Target &target, const int x, const int y, const uint32_t colorKey);
+  // the source over the target, weighted by the source's straight alpha
+  static void blitAlpha(const Image &source, const Target &target, const int x, const int y);
+
+  static const char *getKernelName();
+  // scalar first, then every SIMD kernel set this CPU runs
+  static std::vector<const char *> getSupportedKernelNames();
+  // forces a kernel set, for benchmarking them against each other; false when it isn't supported here
+  static bool setKernels(const char *name);
+};
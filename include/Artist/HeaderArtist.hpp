@@ -1,7 +1,10 @@
 #pragma once
 
+#include <FrameTimer.hpp>
 #include <Minesweeper.hpp>
+#include <Sprites.hpp>
 #include <cstdint>
+#include <optional>
 #include <vector>
 
 #include "BaseArtist.hpp"
@@ -10,8 +13,29 @@
 class HeaderArtist : public BaseArtist
 {
 public:
+  // what the header widgets currently show, so updateHeader only redraws the ones that changed
+  struct DrawnState
+  {
+    int remainingFlags = -1;
+    int secondsElapsed = -1;
+    std::optional<SpriteId> resetButtonSprite;
+    std::optional<SpriteId> configButtonSprite;
+  };
+
   static void drawHeader(std::vector<uint32_t> &buff, const int width, const int buffSize);
-  static void updateHeader(std::vector<uint32_t> &buff, const int width, const Minesweeper &gameState);
+  // appends the rects it redrew to damage
+  static void updateHeader(
+      std::vector<uint32_t> &buff,
+      const int width,
+      const Minesweeper &gameState,
+      DrawnState &drawn,
+      std::vector<Rect> &damage);
+  // p50/p95/p99 per phase in microseconds over the top-left of the minefield, one row per phase
+  static void drawFrameStats(
+      std::vector<uint32_t> &buff,
+      const int width,
+      const FrameTimer::Stats &stats,
+      std::vector<Rect> &damage);
 
   static void drawRaisedResetButtonSprite(std::vector<uint32_t> &buff, const int width);
   static void drawPressedResetButtonSprite(std::vector<uint32_t> &buff, const int width);
@@ -24,6 +48,6 @@ private:
   static void drawTriDigit(std::vector<uint32_t> &buff, const int width, const Rect rect, const int n);
   static void drawGear(std::vector<uint32_t> &buff, const int width, double center = -1);
 
-  static const std::vector<uint32_t> &getResetButtonSprite(const Minesweeper &gameState);
-  static const std::vector<uint32_t> &getConfigButtonSprite(const Minesweeper &gameState);
+  static SpriteId getResetButtonSprite(const Minesweeper &gameState);
+  static SpriteId getConfigButtonSprite(const Minesweeper &gameState);
 };
\ No newline at end of file
@@ -1,16 +1,29 @@
 #pragma once
 
 #include <Minesweeper.hpp>
+#include <Sprites.hpp>
 #include <config.hpp>
 #include <cstdint>
 #include <vector>
 
 #include "BaseArtist.hpp"
+#include "Rect.h"
+
+class ThreadPool;
 
 class MinefieldArtist : public BaseArtist
 {
 public:
-  static void updateMinefield(std::vector<uint32_t> &buff, const int width, Minesweeper &gameState);
+  // draws the cells the engine marked dirty and appends their bounding rect to damage; with a pool, full redraws of
+  // big boards are split into numThreads row bands (the pool's workers plus the caller when 0) drawn in parallel, with
+  // the same result
+  static void updateMinefield(
+      std::vector<uint32_t> &buff,
+      const int width,
+      Minesweeper &gameState,
+      std::vector<Rect> &damage,
+      ThreadPool *pool = nullptr,
+      const int numThreads = 0);
 
   static void drawEmptyCellSprite(std::vector<uint32_t> &buff, const int width);
   static void drawHiddenCellSprite(std::vector<uint32_t> &buff, const int width);
@@ -20,14 +33,11 @@ public:
   static void drawClickedMineCellSprite(std::vector<uint32_t> &buff, const int width);
   static void drawNumericSprite(std::vector<uint32_t> &buff, const int width, const int n, const uint32_t c);
 
-private:
-  static int NUMERIC_SPRITE_HEIGHT;
-  static int NUMERIC_SPRITE_WIDTH;
-  static int NUMERIC_SPRITE_PAD;
+  // the sprite a cell currently shows, one of Sprites' cell sprites
+  static SpriteId getCellSprite(const Minesweeper &gameState, const int cellIndex);
 
+private:
   static void drawMine(std::vector<uint32_t> &buff, const int width);
   static void drawFlag(std::vector<uint32_t> &buff, const int width);
   static void drawOne(std::vector<uint32_t> &buff, const int width);
-
-  static const std::vector<uint32_t> &getCellSprite(const Minesweeper &gameState, const int cellIndex);
 };
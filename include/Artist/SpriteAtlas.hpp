@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Minesweeper.hpp>
+#include <Sprites.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Rect.h"
+
+// The minefield cell sprites packed into one image, for renderers that keep the sprites on the GPU and draw the
+// minefield as one unscaled copy per cell instead of rasterizing it on the CPU.
+class SpriteAtlas
+{
+public:
+  struct Copy
+  {
+    Rect source;
+    Rect target;
+  };
+
+  // packs the cell sprites of Sprites::getInstance(), so the settings have to be initialized first
+  SpriteAtlas();
+
+  int getWidth() const { return width; }
+  int getHeight() const { return height; }
+  const std::vector<uint32_t> &getPixels() const { return pixels; }
+
+  // one copy per cell, placed exactly where MinefieldArtist would draw it
+  void appendMinefieldCopies(const Minesweeper &gameState, std::vector<Copy> &copies) const;
+
+private:
+  int width = 0;
+  int height = 0;
+  std::vector<uint32_t> pixels;
+  // indexed by SpriteId, only the cell sprites are set
+  std::array<Rect, Sprites::NUM_SPRITES> spriteRects{};
+};
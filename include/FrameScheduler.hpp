@@ -0,0 +1,23 @@
+#pragma once
+
+#include <Minesweeper.hpp>
+#include <SDL2/SDL.h>
+#include <vector>
+
+#include "Window/Window.hpp"
+
+// Renders every window once per frame and then presents only the ones that changed, each at most once, in the order
+// they were added. Exposes and lost render targets invalidate the affected windows.
+class FrameScheduler
+{
+public:
+  void addWindow(Window &window) { windows.push_back(&window); }
+
+  void handleEvent(const SDL_Event &event);
+  void render(Minesweeper &game);
+  void present();
+
+private:
+  std::vector<Window *> windows;
+  std::vector<Window *> changedWindows;
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <SpscRing.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Per-phase frame timing. The game loop marks the end of each phase of a frame and pushes the finished frame into a
+// lock-free ring; collect() drains the ring into a window of recent frames for the percentiles and, when a CSV path was
+// given, appends every frame to the file. Whatever the loop doesn't mark (the limitFPS sleep) is never counted.
+class FrameTimer
+{
+public:
+  enum class Phase
+  {
+    EVENTS,
+    TIMER,
+    DRAW,
+    PRESENT,
+    // sum of the phases above
+    FRAME,
+  };
+  static constexpr int NUM_PHASES = 5;
+
+  struct Stats
+  {
+    // microseconds, indexed by Phase, over the last WINDOW_SIZE frames
+    std::array<double, NUM_PHASES> p50{};
+    std::array<double, NUM_PHASES> p95{};
+    std::array<double, NUM_PHASES> p99{};
+    int numFrames = 0;
+  };
+
+  // an empty csvPath records nothing to disk
+  explicit FrameTimer(const std::string &csvPath = "");
+  ~FrameTimer();
+
+  FrameTimer(const FrameTimer &) = delete;
+  FrameTimer &operator=(const FrameTimer &) = delete;
+
+  // producer side, called by the thread running the frame
+  void startFrame();
+  // adds the time since the previous mark (or startFrame) to phase
+  void mark(const Phase phase);
+  void endFrame();
+
+  // consumer side
+  void collect();
+  const Stats &getStats() const { return stats; }
+  uint64_t getNumDroppedFrames() const { return numDroppedFrames.load(std::memory_order_relaxed); }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Sample
+  {
+    uint64_t frameIndex;
+    std::array<float, NUM_PHASES> microseconds;
+  };
+
+  static constexpr std::size_t RING_CAPACITY = 1024;
+  static constexpr std::size_t WINDOW_SIZE = 600;
+
+  SpscRing<Sample, RING_CAPACITY> ring;
+  Sample current{};
+  Clock::time_point lastMark;
+  uint64_t numFrames = 0;
+  std::atomic<uint64_t> numDroppedFrames{0};
+
+  std::vector<Sample> window;
+  std::size_t windowIndex = 0;
+  std::vector<float> scratch;
+  Stats stats;
+
+  std::ofstream csv;
+
+  void updateStats();
+};
@@ -1,12 +1,16 @@
 #pragma once
 
+#include <FrameScheduler.hpp>
+#include <FrameTimer.hpp>
 #include <Minesweeper.hpp>
 #include <Renderer.hpp>
+#include <chrono>
 
 class GameLoop
 {
 public:
-  GameLoop(Minesweeper &, Renderer &);
+  // startTime is when the process started, for the MINESWEEPER_STARTUP_TIMES report
+  GameLoop(Minesweeper &, Renderer &, const std::chrono::steady_clock::time_point startTime);
 
   void run();
 
@@ -15,11 +19,27 @@ private:
   Renderer &renderer;
 
   bool isRunning = false;
+  // EVENT_DRIVEN=1: block in SDL_WaitEventTimeout until input, an expose or the next timer second instead of polling
+  // at a fixed rate
+  const bool isEventDriven;
 
-  static const int frameDelayMs = 16; // ~60 fps
+  // MINESWEEPER_FRAME_TIMES=path writes every frame's phase timings there as CSV when the loop exits
+  FrameTimer frameTimer;
+  FrameScheduler frameScheduler;
+
+  // MINESWEEPER_STARTUP_TIMES=1 prints the time to the first frame, and how much of it went to the sprites
+  const bool isStartupReported;
+  const std::chrono::steady_clock::time_point startTime;
+
+  static const int frameDelayMs = 16;       // ~60 fps
+  static const int frameStatsInterval = 30; // frames between overlay refreshes
+  static const int oneSecondMs = 1000;
 
   void handleEvents();
+  void handleEvent(SDL_Event &event);
+  void waitForEvent(const Uint32 lastTime, const Uint32 timerAccumulator);
   void updateTimer(Uint32 &lastTime, Uint32 &timerAccumulator);
   void render();
   void limitFPS(Uint32 &frameStart);
-};
\ No newline at end of file
+  void reportStartup(const std::chrono::steady_clock::duration spritesWait) const;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <MineCounter.hpp>
+#include <Minesweeper.hpp>
+#include <Random.hpp>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Unbounded board: cells live in CHUNK_SIZE x CHUNK_SIZE chunks that are generated from the seed (and the first
+// click's safe zone) only when a reveal reaches them, so memory tracks the explored area rather than a board size.
+// Cells in chunks that were never generated read back as plain hidden cells.
+class InfiniteMinesweeper
+{
+public:
+  static constexpr int CHUNK_SIZE = 64;
+  // bounds the cells a single call reveals, since a sparse enough board opens an unbounded region; the rest of the
+  // flood fill waits for continueFloodFill
+  static constexpr int MAX_REVEALED_CELLS_PER_CLICK = 1 << 20;
+
+  struct Position
+  {
+    int64_t row;
+    int64_t col;
+  };
+
+  InfiniteMinesweeper(const uint64_t seed, const double mineDensity);
+  ~InfiniteMinesweeper() = default;
+
+  Minesweeper::Cell getCell(const int64_t row, const int64_t col) const;
+  // cells revealed by the most recent click or continueFloodFill, in reveal order
+  const std::vector<Position> &getRevealedCells() const { return revealedCells; }
+  // a flood fill hit MAX_REVEALED_CELLS_PER_CLICK, so revealed empty cells still border hidden ones
+  bool getIsFloodFillPending() const { return !floodFrontier.empty(); }
+  std::size_t getNumChunks() const { return chunks.size(); }
+  int64_t getNumRevealedCells() const { return numRevealedCells; }
+  int64_t getNumFlags() const { return numFlags; }
+  uint64_t getSeed() const { return seed; }
+  bool getIsGameOver() const { return isGameOver; }
+
+  void handleLeftClick(const int64_t row, const int64_t col);
+  void handleRightClick(const int64_t row, const int64_t col);
+  void handleMiddleClick(const int64_t row, const int64_t col);
+  // reveals up to MAX_REVEALED_CELLS_PER_CLICK more cells of a pending flood fill; a left click on a revealed cell
+  // does the same
+  void continueFloodFill();
+  void reset(const uint64_t newSeed);
+
+private:
+  struct Chunk
+  {
+    std::array<Minesweeper::Cell, CHUNK_SIZE * CHUNK_SIZE> cells;
+    bool isCounted = false;
+  };
+
+  // the full 64-bit chunk coordinates, so chunks however far apart never share an entry
+  struct ChunkCoord
+  {
+    int64_t row;
+    int64_t col;
+
+    bool operator==(const ChunkCoord &other) const { return row == other.row && col == other.col; }
+  };
+
+  struct ChunkCoordHash
+  {
+    std::size_t operator()(const ChunkCoord &coord) const { return static_cast<std::size_t>(getChunkHash(coord)); }
+  };
+
+  uint64_t seed;
+  int minesPerChunk;
+  Position firstClick = {0, 0};
+  std::unordered_map<ChunkCoord, Chunk, ChunkCoordHash> chunks;
+  std::vector<Position> revealedCells;
+  // revealed empty cells whose neighbours the flood fill hasn't revealed yet
+  std::deque<Position> floodFrontier;
+  std::vector<uint8_t> countBuffer;
+  MineCounter mineCounter;
+  int64_t numRevealedCells = 0;
+  int64_t numFlags = 0;
+  bool isGameOver = false;
+  bool isFirstClick = true;
+
+  // clang-format off
+  const std::array<std::pair<int, int>, 8> ADJACENCY_OFFSETS = {{
+    { 1, -1}, { 1, 0}, { 1, 1},
+    { 0, -1},          { 0, 1},
+    {-1, -1}, {-1, 0}, {-1, 1}
+  }};
+  // clang-format on
+
+  static int64_t toChunkCoord(const int64_t n) { return n >= 0 ? n / CHUNK_SIZE : (n + 1) / CHUNK_SIZE - 1; }
+  static int toLocalIndex(const int64_t row, const int64_t col);
+  static uint64_t getChunkHash(const ChunkCoord &coord);
+
+  Chunk &getMinedChunk(const int64_t chunkRow, const int64_t chunkCol);
+  Chunk &getCountedChunk(const int64_t chunkRow, const int64_t chunkCol);
+  Minesweeper::Cell &getCountedCell(const int64_t row, const int64_t col);
+
+  void clearRevealedCells();
+  void revealCell(const int64_t row, const int64_t col);
+  void floodFillEmptyCells();
+  void revealGeneratedMines();
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+// A whole file mapped read-only into memory. Where mmap isn't available (Windows) the file is read into a buffer
+// instead, so callers see the same thing either way. The data starts on a cache line boundary.
+class MappedFile
+{
+public:
+  // nullptr when the file doesn't exist, can't be read or is empty
+  static std::unique_ptr<MappedFile> open(const std::filesystem::path &path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const uint8_t *getData() const { return data; }
+  std::size_t getSize() const { return size; }
+
+private:
+  struct alignas(64) CacheLine
+  {
+    uint8_t bytes[64];
+  };
+
+  MappedFile() = default;
+
+  const uint8_t *data = nullptr;
+  std::size_t size = 0;
+  bool isMapped = false;
+  // holds the contents when they were read rather than mapped
+  std::vector<CacheLine> contents;
+};
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Computes every cell's adjacent mine count as a separable 3x3 box sum over the mine bitplane. Rows are processed
+// with SSE2/AVX2 kernels picked at runtime from the CPU's features, with a scalar fallback elsewhere.
+class MineCounter
+{
+public:
+  // cells are packed Minesweeper::Cell bytes; the mine bit is read and the low nibble is overwritten with the count
+  void countAdjacentMines(uint8_t *cells, const int width, const int height);
+
+  static const char *getKernelName();
+
+private:
+  std::vector<uint8_t> paddedMines;
+  std::vector<uint8_t> rowSums;
+};
@@ -1,34 +1,71 @@
 #pragma once
 
-#include <SDL2/SDL.h>
+#include <MineCounter.hpp>
+#include <Random.hpp>
 #include <array>
+#include <cstdint>
 #include <set>
 #include <utility>
 #include <vector>
 
+class NoGuessGenerator;
+
 class Minesweeper
 {
-private:
-  struct Cell
+public:
+  // one byte per cell: low nibble holds the adjacent mine count, high nibble the state flags
+  class Cell
   {
-    bool isMine;
-    bool isHidden;
-    bool isFlagged;
-    bool isClicked = false;
-    unsigned int nAdjacentMines = 0;
+  public:
+    static constexpr uint8_t ADJACENT_MINES_MASK = 0x0f;
+    static constexpr uint8_t MINE_BIT = 1 << 4;
+    static constexpr uint8_t HIDDEN_BIT = 1 << 5;
+    static constexpr uint8_t FLAGGED_BIT = 1 << 6;
+    static constexpr uint8_t CLICKED_BIT = 1 << 7;
+
+    bool getIsMine() const { return bits & MINE_BIT; }
+    bool getIsHidden() const { return bits & HIDDEN_BIT; }
+    bool getIsFlagged() const { return bits & FLAGGED_BIT; }
+    bool getIsClicked() const { return bits & CLICKED_BIT; }
+    int getNumAdjacentMines() const { return bits & ADJACENT_MINES_MASK; }
+    // the whole packed byte, for tables keyed on a cell's complete state
+    uint8_t getBits() const { return bits; }
+
+    void setIsMine(const bool newVal) { setBit(MINE_BIT, newVal); }
+    void setIsHidden(const bool newVal) { setBit(HIDDEN_BIT, newVal); }
+    void setIsFlagged(const bool newVal) { setBit(FLAGGED_BIT, newVal); }
+    void setIsClicked(const bool newVal) { setBit(CLICKED_BIT, newVal); }
+    void incrementNumAdjacentMines() { ++bits; }
+
+  private:
+    uint8_t bits = HIDDEN_BIT;
+
+    void setBit(const uint8_t bit, const bool newVal) { bits = newVal ? bits | bit : bits & ~bit; }
   };
 
-public:
+  static_assert(sizeof(Cell) == 1, "Cell must stay packed into a single byte");
+
   using Minefield = std::vector<Cell>;
 
-  Minesweeper();
+  Minesweeper(const int gridWidth, const int gridHeight, const int numMines);
   ~Minesweeper() = default;
 
+  int getGridWidth() const { return gridWidth; }
+  int getGridHeight() const { return gridHeight; }
   const Minefield &getMinefield() const { return minefield; }
+  // cell indices revealed by the most recent click, in reveal order
+  const std::vector<int> &getRevealedCells() const { return revealedCells; }
+  // cell indices whose sprite may have changed since the last clearDirtyCells, for the renderer; when
+  // getIsFullRedrawNeeded() is set the list is meaningless and every cell has to be redrawn
+  const std::vector<int> &getDirtyCells() const { return dirtyCells; }
+  bool getIsFullRedrawNeeded() const { return isFullRedrawNeeded; }
   int getNumMines() const { return numMines; }
   int getNumFlags() const { return numFlags; }
   int getRemainingFlags() const { return numMines - numFlags; }
+  int getNumHiddenSafeCells() const { return numHiddenSafeCells; }
   int getSecondsElapsed() const { return secondsElapsed; }
+  // together with the first click position this fully determines the board, no-guess or not
+  uint64_t getSeed() const { return seed; }
   bool getIsGameOver() const { return isGameOver; }
   bool getIsGameWon() const { return isGameWon; }
   bool getIsResetButtonPressed() const { return isResetButtonPressed; }
@@ -38,18 +75,40 @@ public:
   void setIsResetButtonPressed(const bool newVal) { isResetButtonPressed = newVal; }
   void setIsConfigButtonPressed(const bool newVal) { isConfigButtonPressed = newVal; }
   void setShowConfigWindow(const bool newVal) { showConfigWindow = newVal; }
+  // with a generator set, first clicks only open boards the Solver can clear without guessing; nullptr turns it off
+  void setNoGuessGenerator(NoGuessGenerator *newVal) { noGuessGenerator = newVal; }
 
   void handleLeftClick(const int row, const int col);
   void handleRightClick(const int row, const int col);
   void handleMiddleClick(const int row, const int col);
   void incrementTimer() { ++secondsElapsed; };
+  void clearDirtyCells();
+  void markAllCellsDirty();
   void checkForGameWon();
   void reset();
+  void reset(const uint64_t newSeed);
+  void startGame(const uint64_t newSeed, const int row, const int col);
 
 private:
+  // lets the benchmarks time private steps in isolation
+  friend class BenchAccess;
+
+  int gridWidth;
+  int gridHeight;
+  int targetNumMines;
+
   Minefield minefield;
+  MineCounter mineCounter;
+  NoGuessGenerator *noGuessGenerator = nullptr;
+  Random seedSource;
+  uint64_t seed = 0;
+  std::vector<int> revealedCells;
+  std::vector<int> dirtyCells;
+  bool isFullRedrawNeeded = true;
   int numMines = 0;
   int numFlags = 0;
+  int numFlaggedMines = 0;
+  int numHiddenSafeCells = 0;
   int secondsElapsed = 0;
   bool isGameOver = false;
   bool isGameWon = false;
@@ -58,6 +117,8 @@ private:
   bool isConfigButtonPressed = false;
   bool showConfigWindow = false;
 
+  static constexpr int SPARSE_BOARD_CELLS_PER_MINE = 64;
+
   // clang-format off
   const std::array<std::pair<int, int>, 8> ADJACENCY_OFFSETS = {{
     { 1, -1}, { 1, 0}, { 1, 1},
@@ -66,9 +127,14 @@ private:
   }};
   // clang-format on
 
-  Minefield initMinefield();
+  void clearMinefield();
+  void markCellDirty(const int index);
+  void markRevealedCellsDirty();
+  void initMinefield(const int safeRow, const int safeCol);
+  void placeMine(const int index);
   int rowColToIndex(const int row, const int col) const;
+  bool isValidCell(const int row, const int col) const;
+  void revealCell(const int row, const int col);
   void revealAdjacentCells(const int row, const int col);
-  void floodFillEmptyCells(const int row, const int col);
-  void floodFillEmptyCellsRecursive(const int row, const int col, std::set<std::pair<int, int>> &visited);
+  const std::vector<int> &floodFillEmptyCells(const int row, const int col);
 };
\ No newline at end of file
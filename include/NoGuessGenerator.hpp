@@ -0,0 +1,46 @@
+#pragma once
+
+#include <ThreadPool.hpp>
+#include <chrono>
+#include <cstdint>
+
+// Searches for a board the Solver can clear from the first click without ever guessing. Candidate seeds are derived
+// from a starting seed and verified concurrently on the pool; the lowest-numbered candidate that passes wins and
+// stops the workers still searching past it. The search is bounded by a time budget and an attempt limit. The result
+// never depends on timing beyond whether the search made it in time: a passing candidate only counts once every lower
+// one has been ruled out, and when nothing passes the candidate the Solver got furthest on is only used if all of them
+// were tried, otherwise it's the starting seed itself.
+class NoGuessGenerator
+{
+public:
+  static constexpr std::chrono::milliseconds DEFAULT_TIME_BUDGET{250};
+  static constexpr int DEFAULT_MAX_ATTEMPTS = 10000;
+
+  NoGuessGenerator(
+      ThreadPool &pool,
+      const std::chrono::milliseconds timeBudget = DEFAULT_TIME_BUDGET,
+      const int maxAttempts = DEFAULT_MAX_ATTEMPTS);
+  ~NoGuessGenerator() = default;
+
+  // seed for Minesweeper::startGame(seed, row, col); firstSeed itself is candidate 0
+  uint64_t findSeed(
+      const int gridWidth,
+      const int gridHeight,
+      const int numMines,
+      const int row,
+      const int col,
+      const uint64_t firstSeed);
+
+  // about the most recent findSeed
+  int getNumAttempts() const { return numAttempts; }
+  bool getIsNoGuess() const { return isNoGuess; }
+
+private:
+  ThreadPool &pool;
+  std::chrono::milliseconds timeBudget;
+  int maxAttempts;
+  int numAttempts = 0;
+  bool isNoGuess = false;
+
+  static uint64_t toCandidateSeed(const uint64_t firstSeed, const int attempt);
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <Minesweeper.hpp>
+#include <ThreadPool.hpp>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Exact mine probability of every hidden cell, given only what the player can see: the revealed numbers, which cells
+// are still hidden and the total mine count. The frontier (hidden cells next to a revealed number) is split into
+// independent components, each component's valid mine layouts are enumerated by backtracking and tallied by mine
+// count, and the tallies are combined with a binomial weight for how the remaining mines can fill the other hidden
+// cells. Components are enumerated in parallel on the pool. Player flags are ignored.
+class ProbabilityEngine
+{
+public:
+  ProbabilityEngine(const Minesweeper &game, ThreadPool &pool);
+  ~ProbabilityEngine() = default;
+
+  // returns whether the result is exact; components still being enumerated when the budget runs out are treated as
+  // unconstrained hidden cells instead
+  bool compute(const std::chrono::milliseconds timeBudget);
+
+  // indexed like the minefield, 0 for revealed cells
+  const std::vector<double> &getMineProbabilities() const { return mineProbabilities; }
+  int getNumComponents() const { return static_cast<int>(components.size()); }
+  int getNumTimedOutComponents() const { return numTimedOutComponents; }
+
+private:
+  struct Component
+  {
+    // frontier cells, in the order they are assigned
+    std::vector<int> cells;
+    // the revealed numbers bordering them
+    std::vector<int> constraints;
+    // mines each number still needs and how many of the cells it touches
+    std::vector<int> constraintMines;
+    std::vector<int> constraintCells;
+    // numbers bordering cells[i], as indices into constraints
+    std::vector<int> cellConstraintOffsets;
+    std::vector<int> cellConstraints;
+    // layouts[k] is the share of valid layouts with k mines, cellMines[k][i] the share of those where cells[i] is a
+    // mine; both normalised by the total layout count so many components don't overflow when combined
+    std::vector<double> layouts;
+    std::vector<std::vector<double>> cellMines;
+    bool isTimedOut = false;
+  };
+
+  const Minesweeper &game;
+  ThreadPool &pool;
+  std::vector<double> mineProbabilities;
+  std::vector<Component> components;
+  int numTimedOutComponents = 0;
+
+  // clang-format off
+  const std::array<std::pair<int, int>, 8> ADJACENCY_OFFSETS = {{
+    { 1, -1}, { 1, 0}, { 1, 1},
+    { 0, -1},          { 0, 1},
+    {-1, -1}, {-1, 0}, {-1, 1}
+  }};
+  // clang-format on
+
+  // how often enumeration checks the clock, in search steps
+  static constexpr uint32_t DEADLINE_CHECK_INTERVAL = 1 << 14;
+
+  bool isValidCell(const int row, const int col) const;
+  template <typename Callback> void forEachNeighbour(const int index, Callback callback) const;
+
+  void findComponents();
+  void enumerate(Component &component, const int maxMines, const std::chrono::steady_clock::time_point deadline) const;
+  void combine(const int numMines, const int numOutsideCells);
+};
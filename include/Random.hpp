@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+
+// xoshiro256** seeded through splitmix64: 32 bytes of state, cheap to reseed and identical on every platform
+class Random
+{
+public:
+  explicit Random(const uint64_t seed = 0) { reseed(seed); }
+
+  void reseed(uint64_t seed)
+  {
+    for (auto &word : state)
+    {
+      word = splitMix64(seed);
+    }
+  }
+
+  uint64_t next()
+  {
+    const uint64_t result = rotl(state[1] * 5, 7) * 9;
+    const uint64_t t = state[1] << 17;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+
+    return result;
+  }
+
+  // uniform in [0, bound) without modulo bias (Lemire's multiply-shift with rejection)
+  uint32_t nextBelow(const uint32_t bound)
+  {
+    uint64_t product = (next() >> 32) * bound;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < bound)
+    {
+      const uint32_t threshold = -bound % bound;
+      while (low < threshold)
+      {
+        product = (next() >> 32) * bound;
+        low = static_cast<uint32_t>(product);
+      }
+    }
+    return product >> 32;
+  }
+
+private:
+  uint64_t state[4];
+
+  static uint64_t rotl(const uint64_t x, const int k) { return (x << k) | (x >> (64 - k)); }
+
+  static uint64_t splitMix64(uint64_t &x)
+  {
+    uint64_t z = (x += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+};
@@ -3,6 +3,7 @@
 #include <Minesweeper.hpp>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
+#include <ThreadPool.hpp>
 #include <config.hpp>
 #include <iostream>
 #include <memory>
@@ -29,7 +30,8 @@ public:
     return true;
   }
 
-  Renderer() { gameWindow.init(); }
+  // the game window draws big minefields on pool's workers too
+  explicit Renderer(ThreadPool &pool) : gameWindow(pool) { gameWindow.init(); }
 
   ~Renderer() { SDL_Quit(); };
 
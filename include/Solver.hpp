@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Minesweeper.hpp>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Deterministic deduction over the revealed numbers of a Minesweeper board. Each revealed number is a constraint on
+// its hidden neighbours; the solver keeps the frontier of numbers that still touch undecided cells and, fed the delta
+// of every click, re-examines only the constraints that delta (or its own deductions) affected. Deductions are
+// single-constraint (all safe / all mines) and pair-wise between overlapping constraints. Player flags are ignored.
+class Solver
+{
+public:
+  explicit Solver(const Minesweeper &game);
+  ~Solver() = default;
+
+  // call after the game is reset
+  void reset();
+  // feed Minesweeper::getRevealedCells after every click
+  void update(const std::vector<int> &revealedCells);
+
+  // deduced safe cells that are still hidden
+  const std::vector<int> &getSafeCells() const { return safeCells; }
+  // every deduced mine
+  const std::vector<int> &getMineCells() const { return mineCells; }
+  // revealed numbers that still border undecided hidden cells
+  const std::vector<int> &getFrontier() const { return frontier; }
+  bool getIsKnownSafe(const int index) const { return knowledge[index] == Knowledge::SAFE; }
+  bool getIsKnownMine(const int index) const { return knowledge[index] == Knowledge::MINE; }
+
+private:
+  enum class Knowledge : uint8_t
+  {
+    UNKNOWN,
+    SAFE,
+    MINE,
+  };
+
+  struct Constraint
+  {
+    std::array<int, 8> unknowns;
+    int numUnknowns = 0;
+    int remainingMines = 0;
+  };
+
+  const Minesweeper &game;
+  std::vector<Knowledge> knowledge;
+  std::vector<int> safeCells;
+  std::vector<int> safeCellPositions;
+  std::vector<int> mineCells;
+  std::vector<int> frontier;
+  std::vector<int> frontierPositions;
+  std::vector<int> dirty;
+  std::vector<bool> isDirty;
+
+  // clang-format off
+  const std::array<std::pair<int, int>, 8> ADJACENCY_OFFSETS = {{
+    { 1, -1}, { 1, 0}, { 1, 1},
+    { 0, -1},          { 0, 1},
+    {-1, -1}, {-1, 0}, {-1, 1}
+  }};
+  // clang-format on
+
+  bool isValidCell(const int row, const int col) const;
+  bool isConstraint(const int index) const;
+  Constraint getConstraint(const int index) const;
+
+  void markDirtyNeighbours(const int index);
+  void markDirty(const int index);
+  void setKnowledge(const int index, const Knowledge newKnowledge);
+  void updateFrontier(const int index, const bool isOnFrontier);
+  void removeSafeCell(const int index);
+  void processConstraint(const int index);
+  void applyPairRule(const Constraint &a, const Constraint &b);
+};
@@ -1,57 +1,126 @@
 #pragma once
 
+#include <Blitter.hpp>
+#include <MappedFile.hpp>
+#include <ThreadPool.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
-#include <map>
+#include <filesystem>
 #include <memory>
+#include <mutex>
 #include <vector>
 
-class Sprites
+// every sprite the artists draw; EMPTY through EIGHT are consecutive, so a cell's sprite is EMPTY plus its mine count
+enum class SpriteId : uint8_t
 {
-private:
-  struct SpriteData
-  {
-    std::vector<uint32_t> raisedResetButton;
-    std::vector<uint32_t> pressedResetButton;
-    std::vector<uint32_t> winnerResetButton;
-    std::vector<uint32_t> loserResetButton;
-    std::vector<uint32_t> raisedConfigButton;
-    std::vector<uint32_t> pressedConfigButton;
-    std::vector<uint32_t> empty;
-    std::vector<uint32_t> hidden;
-    std::vector<uint32_t> flag;
-    std::vector<uint32_t> mine;
-    std::vector<uint32_t> clickedMine;
-    std::vector<uint32_t> redXMine;
-    std::vector<uint32_t> zero;
-    std::vector<uint32_t> one;
-    std::vector<uint32_t> two;
-    std::vector<uint32_t> three;
-    std::vector<uint32_t> four;
-    std::vector<uint32_t> five;
-    std::vector<uint32_t> six;
-    std::vector<uint32_t> seven;
-    std::vector<uint32_t> eight;
-    std::map<int, std::vector<uint32_t>> intToSpriteMap;
-  };
+  RAISED_RESET_BUTTON,
+  PRESSED_RESET_BUTTON,
+  WINNER_RESET_BUTTON,
+  LOSER_RESET_BUTTON,
+  RAISED_CONFIG_BUTTON,
+  PRESSED_CONFIG_BUTTON,
+  HIDDEN,
+  FLAG,
+  MINE,
+  CLICKED_MINE,
+  RED_X_MINE,
+  EMPTY,
+  ONE,
+  TWO,
+  THREE,
+  FOUR,
+  FIVE,
+  SIX,
+  SEVEN,
+  EIGHT,
+};
 
+// All sprites live in one buffer, each starting on its own cache line, so drawing a frame walks a few contiguous
+// kilobytes instead of a heap allocation per sprite. Sprites are square. The buffer is baked once per cell size and
+// cached on disk; later launches map the cached file instead of drawing the sprites again.
+class Sprites
+{
 public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr int NUM_SPRITES = static_cast<int>(SpriteId::EIGHT) + 1;
+  // the first and last minefield cell sprites, the ones SpriteAtlas packs
+  static constexpr SpriteId FIRST_CELL_SPRITE = SpriteId::HIDDEN;
+  static constexpr SpriteId LAST_CELL_SPRITE = SpriteId::EIGHT;
+
+  // Draws the sprites on pool's workers, one task per sprite, unless they're cached, and returns without waiting for
+  // them so the caller can go on creating windows. The pool has to outlive the baking.
+  static void startBaking(ThreadPool &pool);
+  // the barrier for startBaking: blocks until every sprite is drawn; draws them right here if nothing started baking
   static Sprites &getInstance();
-  static void
-  copy(const std::vector<uint32_t> &source, std::vector<uint32_t> &target, const int width, const int x, const int y);
 
-  const SpriteData *get();
+  // waits for any drawing tasks still writing into it
+  ~Sprites();
+
+  const uint32_t *getPixels(const SpriteId id) const { return getFirstPixel() + offsets[toIndex(id)]; }
+  // width and height in pixels
+  int getSize(const SpriteId id) const { return sizes[toIndex(id)]; }
+  Blitter::Image getImage(const SpriteId id) const { return {getPixels(id), getSize(id), getSize(id), getSize(id)}; }
+
+  bool getIsCached() const { return cacheFile != nullptr; }
+  // from the start of the constructor until the last sprite was drawn or the cache was mapped
+  Clock::duration getBakeTime() const { return bakeTime; }
 
 private:
-  Sprites();
+  // lets the benchmarks time private steps in isolation
+  friend class BenchAccess;
+
+  static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+  struct alignas(CACHE_LINE_SIZE) CacheLine
+  {
+    uint32_t pixels[CACHE_LINE_SIZE / sizeof(uint32_t)];
+  };
+
+  // an empty cacheDir always draws the sprites and caches nothing; a null pool draws them before returning
+  explicit Sprites(const std::filesystem::path &cacheDir, ThreadPool *pool = nullptr);
 
   Sprites(const Sprites &) = delete;
   Sprites &operator=(const Sprites &) = delete;
   Sprites(Sprites &&) = delete;
   Sprites &operator=(Sprites &&) = delete;
 
-  std::unique_ptr<SpriteData> data = std::make_unique<SpriteData>();
+  // the pixels are in exactly one of these
+  std::vector<CacheLine> buffer;
+  std::unique_ptr<MappedFile> cacheFile;
+  const uint32_t *firstPixel = nullptr;
+
+  // in pixels from firstPixel
+  std::array<std::size_t, NUM_SPRITES> offsets{};
+  std::array<int, NUM_SPRITES> sizes{};
+  std::size_t numPixels = 0;
+
+  Clock::time_point bakeStart;
+  Clock::duration bakeTime{};
+  std::filesystem::path cachePath;
+
+  // set once the pixels are final; the sprites still being drawn by pool workers are counted under bakeMutex
+  std::atomic<bool> isBaked{false};
+  int numUnbakedSprites = 0;
+  std::mutex bakeMutex;
+  std::condition_variable bakeFinished;
+
+  static Sprites &getOrCreate(ThreadPool *pool);
+  static int toIndex(const SpriteId id) { return static_cast<int>(id); }
+
+  const uint32_t *getFirstPixel() const { return firstPixel; }
 
-  void allocateMemory();
-  void drawSprites();
-  void createIntToSpriteMap();
+  void computeLayout();
+  std::filesystem::path getCachePath(const std::filesystem::path &cacheDir) const;
+  bool loadCache(const std::filesystem::path &path);
+  void drawSprites(ThreadPool *pool);
+  void drawSprite(const SpriteId id);
+  // run by the task that drew the last sprite
+  void finishBaking();
+  void waitUntilBaked();
+  void writeCache(const std::filesystem::path &path) const;
 };
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Fixed-capacity queue for exactly one producer thread and one consumer thread. push and pop never lock or allocate;
+// push fails instead of overwriting when the consumer has fallen a full ring behind.
+template <typename T, std::size_t CAPACITY> class SpscRing
+{
+  static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "capacity must be a power of two");
+
+public:
+  bool push(const T &item)
+  {
+    const std::size_t write = writeIndex.load(std::memory_order_relaxed);
+    if (write - readIndex.load(std::memory_order_acquire) == CAPACITY)
+    {
+      return false;
+    }
+
+    items[write & (CAPACITY - 1)] = item;
+    writeIndex.store(write + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(T &item)
+  {
+    const std::size_t read = readIndex.load(std::memory_order_relaxed);
+    if (read == writeIndex.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+
+    item = items[read & (CAPACITY - 1)];
+    readIndex.store(read + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::array<T, CAPACITY> items{};
+  // separate cache lines so the two threads don't bounce one line between them
+  alignas(64) std::atomic<std::size_t> writeIndex{0};
+  alignas(64) std::atomic<std::size_t> readIndex{0};
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads draining a FIFO of tasks, shared by whatever headless work wants more than one core.
+// Tasks must not throw.
+class ThreadPool
+{
+public:
+  // Tasks submitted through a group can be waited for without waiting for everybody else's tasks on the pool. wait()
+  // runs the group's tasks that haven't started yet on the calling thread, so it's safe from inside a pool task too.
+  class TaskGroup
+  {
+  public:
+    explicit TaskGroup(ThreadPool &pool);
+    // waits, since the tasks usually reference the caller's locals
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    void submit(std::function<void()> task);
+    // blocks until every task submitted through this group so far has finished
+    void wait();
+
+  private:
+    friend class ThreadPool;
+
+    ThreadPool &pool;
+    // guarded by the pool's mutex
+    int numUnfinishedTasks = 0;
+    std::condition_variable tasksFinished;
+  };
+
+  // numThreads <= 0 starts one worker per hardware thread
+  explicit ThreadPool(const int numThreads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  int getNumThreads() const { return static_cast<int>(workers.size()); }
+
+  void submit(std::function<void()> task);
+  // blocks until every task submitted so far has finished, including other callers' ones
+  void wait();
+
+private:
+  struct Task
+  {
+    std::function<void()> run;
+    // null for tasks submitted straight to the pool
+    TaskGroup *group;
+  };
+
+  std::vector<std::thread> workers;
+  std::deque<Task> tasks;
+  std::mutex mutex;
+  std::condition_variable taskAvailable;
+  std::condition_variable tasksFinished;
+  int numUnfinishedTasks = 0;
+  bool isStopping = false;
+
+  void push(Task task);
+  // with the mutex held
+  void finish(const Task &task);
+  void runWorker();
+};
@@ -1,25 +1,65 @@
 #pragma once
 
+#include <FrameTimer.hpp>
+#include <HeaderArtist.hpp>
 #include <Minesweeper.hpp>
 #include <SDL2/SDL.h>
+#include <SpriteAtlas.hpp>
+#include <ThreadPool.hpp>
 #include <config.hpp>
 #include <cstdint>
 #include <memory>
 #include <vector>
 
+#include "Rect.h"
 #include "Window.hpp"
 
 class GameWindow : public Window
 {
 public:
-  GameWindow();
+  // rasterPool helps with full minefield redraws when RASTER_THREADS isn't 1
+  explicit GameWindow(ThreadPool &rasterPool);
   ~GameWindow() override = default;
 
   void init() override;
-  void update(Minesweeper &) override;
+  bool update(Minesweeper &) override;
   void handleEvent(SDL_Event &event, Minesweeper &gameState, bool &isGameLoopRunning) const;
 
+  // source of the stats drawn while the overlay is shown
+  void setFrameTimer(FrameTimer *newVal) { frameTimer = newVal; }
+  bool getShowFrameStats() const { return showFrameStats; }
+  void setShowFrameStats(const bool newVal) { showFrameStats = newVal; }
+
+  // draw the minefield with per-cell copies out of a sprite atlas texture instead of rasterizing it into the frame
+  // buffer; the output is the same either way
+  bool getUseSpriteAtlas() const { return useSpriteAtlas; }
+  void setUseSpriteAtlas(const bool newVal);
+
 private:
+  FrameTimer *frameTimer = nullptr;
+  bool showFrameStats = false;
+  bool wasFrameStatsShown = false;
+
+  HeaderArtist::DrawnState drawnHeader;
+  // shared with the rest of the game; helps the game loop's thread with full minefield redraws, null when
+  // RASTER_THREADS is 1
+  ThreadPool *rasterPool = nullptr;
+  // the bands a full redraw is split into, the game loop's thread included; 0 for one per pool worker plus one
+  int numRasterThreads = 1;
+  // frame buffer regions changed since the last upload
+  std::vector<Rect> damage;
+  // the frame buffer's minefield no longer matches the game and has to be redrawn in full
+  bool isMinefieldStale = false;
+
+  bool useSpriteAtlas = config::getSettings().getSpriteAtlas();
+  std::unique_ptr<SpriteAtlas> spriteAtlas;
+  std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> atlasTexture{nullptr, &SDL_DestroyTexture};
+  std::vector<SpriteAtlas::Copy> atlasCopies;
+  Rect frameStatsPanel{};
+
+  void uploadDamage();
+  void renderAtlasMinefield(const Minesweeper &gameState);
+
   const int gameAreaX = config::getSettings().getGridAreaPadX() + config::FRAME_WIDTH;
   const int gameAreaY = config::getSettings().getGridAreaPadY() + config::INFO_PANEL_HEIGHT + 2 * config::FRAME_WIDTH;
 };
\ No newline at end of file
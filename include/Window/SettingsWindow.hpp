@@ -17,7 +17,7 @@ public:
   ~SettingsWindow() override;
 
   void init() override;
-  void update(Minesweeper &) override;
+  bool update(Minesweeper &) override;
   void handleEvent(SDL_Event &event);
 
 private:
@@ -61,8 +61,9 @@ private:
     SettingsField cellSize;
     SettingsField windowWidth;
     SettingsField windowHeight;
+    SettingsField numMines;
 
-    std::array<SettingsField *, 3> items() { return {&cellSize, &windowWidth, &windowHeight}; }
+    std::array<SettingsField *, 4> items() { return {&cellSize, &windowWidth, &windowHeight, &numMines}; }
   } settingsMenuFields;
 
   struct SettingsMenuButtons
@@ -13,7 +13,12 @@ public:
   virtual ~Window() = default;
 
   virtual void init() = 0;
-  virtual void update(Minesweeper &) = 0;
+  // brings the back buffer up to date with the game; false when nothing changed, so the window needs no present
+  virtual bool update(Minesweeper &) = 0;
+  void present() { SDL_RenderPresent(renderer.get()); }
+
+  // the next update redraws everything, e.g. after an expose or a lost render target
+  void invalidate() { isInvalidated = true; }
 
   SDL_Window *getWindow() const { return window.get(); }
   SDL_Renderer *getRenderer() const { return renderer.get(); }
@@ -28,6 +33,7 @@ protected:
   std::unique_ptr<SDL_Renderer, decltype(&SDL_DestroyRenderer)> renderer{nullptr, &SDL_DestroyRenderer};
   std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> texture{nullptr, &SDL_DestroyTexture};
   Uint32 windowID;
+  bool isInvalidated = true;
 
   std::vector<uint32_t> frameBuffer = {};
 };
@@ -1,11 +1,13 @@
 #pragma once
 
-#include <SDL2/SDL.h>
+#include <algorithm>
 #include <cstdint>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <string>
 
 namespace config
 {
@@ -37,6 +39,22 @@ constexpr int DEFAULT_CELL_PIXEL_SIZE = 50;
 constexpr double DEFAULT_GAME_WINDOW_TO_DISPLAY_RATIO = 0.7;
 constexpr double MINE_FREQUENCY = 0.2;
 
+inline int getNumGridCells(const int gameWindowWidth, const int gameWindowHeight, const int cellPixelSize)
+{
+  const int cellSize = std::max(cellPixelSize, 1);
+  const int gridWidth = std::max(gameWindowWidth - 2 * FRAME_WIDTH, 0) / cellSize;
+  const int gridHeight = std::max(gameWindowHeight - INFO_PANEL_HEIGHT - 3 * FRAME_WIDTH, 0) / cellSize;
+  return gridWidth * gridHeight;
+}
+
+inline int getDefaultNumMines(const int gameWindowWidth, const int gameWindowHeight, const int cellPixelSize)
+{
+  return getNumGridCells(gameWindowWidth, gameWindowHeight, cellPixelSize) * MINE_FREQUENCY;
+}
+
+// the most mines Minesweeper places on a grid of numGridCells, which keeps the first click's 3x3 neighbourhood clear
+inline int getMaxNumMines(const int numGridCells) { return std::max(numGridCells - 9, 0); }
+
 inline std::filesystem::path getConfigPath()
 {
   const char *home = std::getenv("HOME");
@@ -47,6 +65,23 @@ inline std::filesystem::path getConfigPath()
   return std::filesystem::path(home) / ".config" / "minesweeper.conf";
 }
 
+// $XDG_CACHE_HOME/minesweeper, falling back to ~/.cache/minesweeper; empty when neither is set
+inline std::filesystem::path getCacheDir()
+{
+  const char *cacheHome = std::getenv("XDG_CACHE_HOME");
+  if (cacheHome && *cacheHome)
+  {
+    return std::filesystem::path(cacheHome) / "minesweeper";
+  }
+
+  const char *home = std::getenv("HOME");
+  if (!home)
+  {
+    return {};
+  }
+  return std::filesystem::path(home) / ".cache" / "minesweeper";
+}
+
 class Settings
 {
 public:
@@ -62,22 +97,40 @@ public:
       cellPixelSize = DEFAULT_CELL_PIXEL_SIZE;
       gameWindowWidth = displayWidth * DEFAULT_GAME_WINDOW_TO_DISPLAY_RATIO;
       gameWindowHeight = displayHeight * DEFAULT_GAME_WINDOW_TO_DISPLAY_RATIO;
+      updateDerivedValues();
 
       writeToFile();
     }
     else
     {
       readFromFile();
+      updateDerivedValues();
     }
+  }
 
+  // headless use (benchmarks, tools): takes the window and cell size as given and never reads or writes the config file
+  void initializeWithoutFile(const int newGameWindowWidth, const int newGameWindowHeight, const int newCellPixelSize)
+  {
+    displayWidth = newGameWindowWidth;
+    displayHeight = newGameWindowHeight;
+    gameWindowWidth = newGameWindowWidth;
+    gameWindowHeight = newGameWindowHeight;
+    cellPixelSize = newCellPixelSize;
     updateDerivedValues();
   }
 
-  bool writeToFile(int newGameWindowWidth = -1, int newGameWindowHeight = -1, int newCellPixelSize = -1) const
+  bool writeToFile(
+      int newGameWindowWidth = -1,
+      int newGameWindowHeight = -1,
+      int newCellPixelSize = -1,
+      int newNumMines = -1) const
   {
     newGameWindowWidth = newGameWindowWidth < 0 ? gameWindowWidth : newGameWindowWidth;
     newGameWindowHeight = newGameWindowHeight < 0 ? gameWindowHeight : newGameWindowHeight;
     newCellPixelSize = newCellPixelSize < 0 ? cellPixelSize : newCellPixelSize;
+    newNumMines = std::min(
+        newNumMines < 0 ? numMines : newNumMines,
+        getMaxNumMines(getNumGridCells(newGameWindowWidth, newGameWindowHeight, newCellPixelSize)));
 
     auto configPath = getConfigPath();
     if (configPath.empty())
@@ -91,6 +144,11 @@ public:
       ofs << "GAME_WINDOW_PIXEL_WIDTH=" << newGameWindowWidth << "\n";
       ofs << "GAME_WINDOW_PIXEL_HEIGHT=" << newGameWindowHeight << "\n";
       ofs << "CELL_PIXEL_SIZE=" << newCellPixelSize << "\n";
+      ofs << "NUM_MINES=" << newNumMines << "\n";
+      ofs << "NO_GUESS=" << noGuess << "\n";
+      ofs << "EVENT_DRIVEN=" << eventDriven << "\n";
+      ofs << "SPRITE_ATLAS=" << spriteAtlas << "\n";
+      ofs << "RASTER_THREADS=" << rasterThreads << "\n";
 
       const bool success = ofs.good();
       ofs.close();
@@ -107,6 +165,12 @@ public:
   int getGameWindowWidth() const { return gameWindowWidth; }
   int getGameWindowHeight() const { return gameWindowHeight; }
   int getCellPixelSize() const { return cellPixelSize; }
+  int getNumMines() const { return numMines; }
+  bool getNoGuess() const { return noGuess != 0; }
+  bool getEventDriven() const { return eventDriven != 0; }
+  bool getSpriteAtlas() const { return spriteAtlas != 0; }
+  // threads drawing the software minefield, the game loop's own included; 0 means one per hardware thread
+  int getRasterThreads() const { return rasterThreads; }
   int getConfigWindowWidth() const { return configWindowWidth; }
   int getConfigWindowHeight() const { return configWindowHeight; }
   int getResetButtonX() const { return resetButtonX; }
@@ -138,7 +202,12 @@ private:
     std::map<std::string, int *> settingsMap = {
         {"GAME_WINDOW_PIXEL_WIDTH", &gameWindowWidth},
         {"GAME_WINDOW_PIXEL_HEIGHT", &gameWindowHeight},
-        {"CELL_PIXEL_SIZE", &cellPixelSize}};
+        {"CELL_PIXEL_SIZE", &cellPixelSize},
+        {"NUM_MINES", &numMines},
+        {"NO_GUESS", &noGuess},
+        {"EVENT_DRIVEN", &eventDriven},
+        {"SPRITE_ATLAS", &spriteAtlas},
+        {"RASTER_THREADS", &rasterThreads}};
 
     std::ifstream ifs(configPath);
     std::string line;
@@ -198,6 +267,12 @@ private:
     gridAreaPadY = (gameAreaHeight % cellPixelSize) / 2;
 
     cellBorderWidth3D = cellPixelSize / 10;
+
+    // config files written before NUM_MINES existed fall back to the default density
+    if (numMines < 0)
+    {
+      numMines = getDefaultNumMines(gameWindowWidth, gameWindowHeight, cellPixelSize);
+    }
   }
 
   // primary
@@ -206,6 +281,11 @@ private:
   int gameWindowWidth = 0;
   int gameWindowHeight = 0;
   int cellPixelSize = DEFAULT_CELL_PIXEL_SIZE;
+  int numMines = -1;
+  int noGuess = 0;
+  int eventDriven = 0;
+  int spriteAtlas = 0;
+  int rasterThreads = 1;
 
   // derived
   int configWindowWidth = 0;
@@ -1,6 +1,7 @@
 #include <BaseArtist.hpp>
 #include <Rect.h>
 #include <algorithm>
+#include <cmath>
 #include <config.hpp>
 #include <cstdint>
 #include <stdexcept>
@@ -0,0 +1,396 @@
+#include <Blitter.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BLITTER_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+constexpr uint32_t ALPHA_MASK = 0xff;
+
+struct Kernels
+{
+  // target[x] = source[x]
+  void (*copyRow)(const uint32_t *source, uint32_t *target, const int width);
+  // target[x] = source[x] unless it equals colorKey
+  void (*colorKeyRow)(const uint32_t *source, uint32_t *target, const int width, const uint32_t colorKey);
+  // target[x] = source[x] over target[x]
+  void (*alphaRow)(const uint32_t *source, uint32_t *target, const int width);
+  const char *name;
+};
+
+// scalar
+
+void copyRowScalar(const uint32_t *source, uint32_t *target, const int begin, const int width)
+{
+  std::copy(source + begin, source + width, target + begin);
+}
+
+void colorKeyRowScalar(
+    const uint32_t *source,
+    uint32_t *target,
+    const int begin,
+    const int width,
+    const uint32_t colorKey)
+{
+  for (int x = begin; x < width; ++x)
+  {
+    if (source[x] != colorKey)
+    {
+      target[x] = source[x];
+    }
+  }
+}
+
+// (s * a + d * (255 - a)) / 255 rounded, exact for every input; the SIMD kernels use the same formula, so all kernel
+// sets produce identical pixels
+uint32_t blendChannel(const uint32_t s, const uint32_t d, const uint32_t a)
+{
+  const uint32_t t = s * a + d * (255 - a) + 128;
+  return (t + (t >> 8)) >> 8;
+}
+
+void alphaRowScalar(const uint32_t *source, uint32_t *target, const int begin, const int width)
+{
+  for (int x = begin; x < width; ++x)
+  {
+    // blending the alpha channel as if the source's were opaque gives a + d * (1 - a), the "over" alpha
+    const uint32_t s = source[x] | ALPHA_MASK;
+    const uint32_t d = target[x];
+    const uint32_t a = source[x] & ALPHA_MASK;
+
+    uint32_t blended = 0;
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+      blended |= blendChannel((s >> shift) & 0xff, (d >> shift) & 0xff, a) << shift;
+    }
+    target[x] = blended;
+  }
+}
+
+const Kernels SCALAR_KERNELS = {
+    [](const uint32_t *source, uint32_t *target, const int width) { copyRowScalar(source, target, 0, width); },
+    [](const uint32_t *source, uint32_t *target, const int width, const uint32_t colorKey)
+    { colorKeyRowScalar(source, target, 0, width, colorKey); },
+    [](const uint32_t *source, uint32_t *target, const int width) { alphaRowScalar(source, target, 0, width); },
+    "scalar",
+};
+
+#ifdef BLITTER_X86
+
+// sse2
+
+__attribute__((target("sse2"))) void copy4SSE2(const uint32_t *source, uint32_t *target, const int x)
+{
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i *>(target + x), _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + x)));
+}
+
+__attribute__((target("sse2"))) void copyRowSSE2(const uint32_t *source, uint32_t *target, const int width)
+{
+  if (width < 4)
+  {
+    copyRowScalar(source, target, 0, width);
+    return;
+  }
+
+  int x = 0;
+  for (; x + 4 <= width; x += 4)
+  {
+    copy4SSE2(source, target, x);
+  }
+  // the tail as one more vector overlapping the last, which writes the same values over a few pixels again
+  if (x < width)
+  {
+    copy4SSE2(source, target, width - 4);
+  }
+}
+
+__attribute__((target("sse2"))) void
+colorKey4SSE2(const uint32_t *source, uint32_t *target, const int x, const __m128i key)
+{
+  const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + x));
+  const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(target + x));
+  const __m128i isKey = _mm_cmpeq_epi32(s, key);
+  _mm_storeu_si128(
+      reinterpret_cast<__m128i *>(target + x), _mm_or_si128(_mm_and_si128(isKey, d), _mm_andnot_si128(isKey, s)));
+}
+
+__attribute__((target("sse2"))) void
+colorKeyRowSSE2(const uint32_t *source, uint32_t *target, const int width, const uint32_t colorKey)
+{
+  if (width < 4)
+  {
+    colorKeyRowScalar(source, target, 0, width, colorKey);
+    return;
+  }
+
+  const __m128i key = _mm_set1_epi32(static_cast<int>(colorKey));
+  int x = 0;
+  for (; x + 4 <= width; x += 4)
+  {
+    colorKey4SSE2(source, target, x, key);
+  }
+  // keyed pixels keep the target and the rest take the source, so going over a pixel twice changes nothing
+  if (x < width)
+  {
+    colorKey4SSE2(source, target, width - 4, key);
+  }
+}
+
+// two pixels widened to 16 bits per channel; lane 0 of each pixel is its alpha
+__attribute__((target("sse2"))) __m128i blendPixelsSSE2(const __m128i s, const __m128i d, const __m128i a)
+{
+  const __m128i all = _mm_set1_epi16(255);
+  const __m128i round = _mm_set1_epi16(128);
+  const __m128i t =
+      _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(d, _mm_sub_epi16(all, a))), round);
+  return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+__attribute__((target("sse2"))) __m128i broadcastAlphaSSE2(const __m128i pixels)
+{
+  return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, 0), 0);
+}
+
+__attribute__((target("sse2"))) void alphaRowSSE2(const uint32_t *source, uint32_t *target, const int width)
+{
+  // blending isn't idempotent, so unlike the copies the tail is done one pixel at a time
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i alphaMask = _mm_set1_epi32(ALPHA_MASK);
+  int x = 0;
+  for (; x + 4 <= width; x += 4)
+  {
+    const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + x));
+    const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(target + x));
+    const __m128i opaque = _mm_or_si128(s, alphaMask);
+
+    const __m128i low = blendPixelsSSE2(
+        _mm_unpacklo_epi8(opaque, zero), _mm_unpacklo_epi8(d, zero), broadcastAlphaSSE2(_mm_unpacklo_epi8(s, zero)));
+    const __m128i high = blendPixelsSSE2(
+        _mm_unpackhi_epi8(opaque, zero), _mm_unpackhi_epi8(d, zero), broadcastAlphaSSE2(_mm_unpackhi_epi8(s, zero)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(target + x), _mm_packus_epi16(low, high));
+  }
+  alphaRowScalar(source, target, x, width);
+}
+
+const Kernels SSE2_KERNELS = {copyRowSSE2, colorKeyRowSSE2, alphaRowSSE2, "sse2"};
+
+// avx2
+
+__attribute__((target("avx2"))) void copy8AVX2(const uint32_t *source, uint32_t *target, const int x)
+{
+  _mm256_storeu_si256(
+      reinterpret_cast<__m256i *>(target + x), _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + x)));
+}
+
+__attribute__((target("avx2"))) void copyRowAVX2(const uint32_t *source, uint32_t *target, const int width)
+{
+  if (width < 8)
+  {
+    copyRowSSE2(source, target, width);
+    return;
+  }
+
+  int x = 0;
+  for (; x + 8 <= width; x += 8)
+  {
+    copy8AVX2(source, target, x);
+  }
+  if (x < width)
+  {
+    copy8AVX2(source, target, width - 8);
+  }
+}
+
+__attribute__((target("avx2"))) void
+colorKey8AVX2(const uint32_t *source, uint32_t *target, const int x, const __m256i key)
+{
+  const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + x));
+  const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(target + x));
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(target + x), _mm256_blendv_epi8(s, d, _mm256_cmpeq_epi32(s, key)));
+}
+
+__attribute__((target("avx2"))) void
+colorKeyRowAVX2(const uint32_t *source, uint32_t *target, const int width, const uint32_t colorKey)
+{
+  if (width < 8)
+  {
+    colorKeyRowSSE2(source, target, width, colorKey);
+    return;
+  }
+
+  const __m256i key = _mm256_set1_epi32(static_cast<int>(colorKey));
+  int x = 0;
+  for (; x + 8 <= width; x += 8)
+  {
+    colorKey8AVX2(source, target, x, key);
+  }
+  if (x < width)
+  {
+    colorKey8AVX2(source, target, width - 8, key);
+  }
+}
+
+__attribute__((target("avx2"))) __m256i blendPixelsAVX2(const __m256i s, const __m256i d, const __m256i a)
+{
+  const __m256i all = _mm256_set1_epi16(255);
+  const __m256i round = _mm256_set1_epi16(128);
+  const __m256i t = _mm256_add_epi16(
+      _mm256_add_epi16(_mm256_mullo_epi16(s, a), _mm256_mullo_epi16(d, _mm256_sub_epi16(all, a))), round);
+  return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+__attribute__((target("avx2"))) __m256i broadcastAlphaAVX2(const __m256i pixels)
+{
+  return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(pixels, 0), 0);
+}
+
+__attribute__((target("avx2"))) void alphaRowAVX2(const uint32_t *source, uint32_t *target, const int width)
+{
+  // unpack and pack both work within 128-bit lanes, so the pixels come back out in order
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i alphaMask = _mm256_set1_epi32(ALPHA_MASK);
+  int x = 0;
+  for (; x + 8 <= width; x += 8)
+  {
+    const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(source + x));
+    const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(target + x));
+    const __m256i opaque = _mm256_or_si256(s, alphaMask);
+
+    const __m256i low = blendPixelsAVX2(
+        _mm256_unpacklo_epi8(opaque, zero),
+        _mm256_unpacklo_epi8(d, zero),
+        broadcastAlphaAVX2(_mm256_unpacklo_epi8(s, zero)));
+    const __m256i high = blendPixelsAVX2(
+        _mm256_unpackhi_epi8(opaque, zero),
+        _mm256_unpackhi_epi8(d, zero),
+        broadcastAlphaAVX2(_mm256_unpackhi_epi8(s, zero)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(target + x), _mm256_packus_epi16(low, high));
+  }
+  alphaRowSSE2(source + x, target + x, width - x);
+}
+
+const Kernels AVX2_KERNELS = {copyRowAVX2, colorKeyRowAVX2, alphaRowAVX2, "avx2"};
+
+#endif
+
+// in order of preference, best last
+const std::vector<const Kernels *> &getSupportedKernels()
+{
+  static const std::vector<const Kernels *> supported = []()
+  {
+    std::vector<const Kernels *> kernels{&SCALAR_KERNELS};
+#ifdef BLITTER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2"))
+    {
+      kernels.push_back(&SSE2_KERNELS);
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+      kernels.push_back(&AVX2_KERNELS);
+    }
+#endif
+    return kernels;
+  }();
+  return supported;
+}
+
+const Kernels *&getKernels()
+{
+  static const Kernels *kernels = getSupportedKernels().back();
+  return kernels;
+}
+
+// calls row(sourceRow, targetRow, width) for each row of source that lands inside target
+template <typename RowFunction>
+void forEachClippedRow(
+    const Blitter::Image &source,
+    const Blitter::Target &target,
+    const int x,
+    const int y,
+    const RowFunction row)
+{
+  const int left = std::max(x, 0);
+  const int top = std::max(y, 0);
+  const int right = std::min(x + source.width, target.width);
+  const int bottom = std::min(y + source.height, target.height);
+  if (left >= right || top >= bottom)
+  {
+    return;
+  }
+
+  const uint32_t *sourceRow = source.pixels + static_cast<std::ptrdiff_t>(top - y) * source.stride + (left - x);
+  uint32_t *targetRow = target.pixels + static_cast<std::ptrdiff_t>(top) * target.stride + left;
+  for (int i = top; i < bottom; ++i)
+  {
+    row(sourceRow, targetRow, right - left);
+    sourceRow += source.stride;
+    targetRow += target.stride;
+  }
+}
+} // namespace
+
+Blitter::Target Blitter::makeTarget(std::vector<uint32_t> &buff, const int width)
+{
+  return {buff.data(), width, static_cast<int>(buff.size()) / width, width};
+}
+
+void Blitter::blitOpaque(const Image &source, const Target &target, const int x, const int y)
+{
+  forEachClippedRow(source, target, x, y, getKernels()->copyRow);
+}
+
+void Blitter::blitColorKey(
+    const Image &source,
+    const Target &target,
+    const int x,
+    const int y,
+    const uint32_t colorKey)
+{
+  const auto colorKeyRow = getKernels()->colorKeyRow;
+  forEachClippedRow(
+      source,
+      target,
+      x,
+      y,
+      [colorKeyRow, colorKey](const uint32_t *sourceRow, uint32_t *targetRow, const int width)
+      { colorKeyRow(sourceRow, targetRow, width, colorKey); });
+}
+
+void Blitter::blitAlpha(const Image &source, const Target &target, const int x, const int y)
+{
+  forEachClippedRow(source, target, x, y, getKernels()->alphaRow);
+}
+
+const char *Blitter::getKernelName() { return getKernels()->name; }
+
+std::vector<const char *> Blitter::getSupportedKernelNames()
+{
+  std::vector<const char *> names;
+  for (const auto *kernels : getSupportedKernels())
+  {
+    names.push_back(kernels->name);
+  }
+  return names;
+}
+
+bool Blitter::setKernels(const char *name)
+{
+  for (const auto *kernels : getSupportedKernels())
+  {
+    if (std::strcmp(kernels->name, name) == 0)
+    {
+      getKernels() = kernels;
+      return true;
+    }
+  }
+  return false;
+}
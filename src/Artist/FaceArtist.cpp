@@ -1,4 +1,5 @@
 #include <FaceArtist.hpp>
+#include <cmath>
 #include <cstdint>
 
 void FaceArtist::drawFaceBase(std::vector<uint32_t> &buff, const int width, double center)
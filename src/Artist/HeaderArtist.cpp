@@ -1,8 +1,12 @@
+#include <Blitter.hpp>
 #include <FaceArtist.hpp>
+#include <FrameTimer.hpp>
 #include <HeaderArtist.hpp>
 #include <MinefieldArtist.hpp>
 #include <Sprites.hpp>
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <config.hpp>
 #include <cstdint>
 #include <vector>
@@ -104,39 +108,125 @@ void HeaderArtist::drawHeader(std::vector<uint32_t> &buff, const int width, cons
       config::Colors::LIGHT_GREY);
 };
 
-void HeaderArtist::updateHeader(std::vector<uint32_t> &buff, const int width, const Minesweeper &gameState)
+void HeaderArtist::updateHeader(
+    std::vector<uint32_t> &buff,
+    const int width,
+    const Minesweeper &gameState,
+    DrawnState &drawn,
+    std::vector<Rect> &damage)
 {
-  drawTriDigit(
-      buff,
-      width,
-      {config::getSettings().getRemainingFlagsX(),
-       config::getSettings().getRemainingFlagsY(),
-       config::INFO_PANEL_BUTTONS_HEIGHT * 2,
-       config::INFO_PANEL_BUTTONS_HEIGHT},
-      gameState.getRemainingFlags());
-
-  Sprites::getInstance().copy(
-      getResetButtonSprite(gameState),
-      buff,
-      config::INFO_PANEL_BUTTONS_HEIGHT,
-      config::getSettings().getResetButtonX(),
-      config::getSettings().getResetButtonY());
+  const Rect remainingFlagsRect{
+      config::getSettings().getRemainingFlagsX(),
+      config::getSettings().getRemainingFlagsY(),
+      config::INFO_PANEL_BUTTONS_HEIGHT * 2,
+      config::INFO_PANEL_BUTTONS_HEIGHT};
+  if (gameState.getRemainingFlags() != drawn.remainingFlags)
+  {
+    drawn.remainingFlags = gameState.getRemainingFlags();
+    drawTriDigit(buff, width, remainingFlagsRect, drawn.remainingFlags);
+    damage.push_back(remainingFlagsRect);
+  }
 
-  Sprites::getInstance().copy(
-      getConfigButtonSprite(gameState),
-      buff,
-      config::INFO_PANEL_BUTTONS_HEIGHT,
-      config::getSettings().getConfigButtonX(),
-      config::getSettings().getConfigButtonY());
+  const auto resetButtonSprite = getResetButtonSprite(gameState);
+  if (resetButtonSprite != drawn.resetButtonSprite)
+  {
+    drawn.resetButtonSprite = resetButtonSprite;
+    Blitter::blitOpaque(
+        Sprites::getInstance().getImage(resetButtonSprite),
+        Blitter::makeTarget(buff, width),
+        config::getSettings().getResetButtonX(),
+        config::getSettings().getResetButtonY());
+    damage.push_back(
+        {config::getSettings().getResetButtonX(),
+         config::getSettings().getResetButtonY(),
+         config::INFO_PANEL_BUTTONS_HEIGHT,
+         config::INFO_PANEL_BUTTONS_HEIGHT});
+  }
 
-  drawTriDigit(
-      buff,
-      width,
-      {config::getSettings().getTimerX(),
-       config::getSettings().getTimerY(),
-       config::INFO_PANEL_BUTTONS_HEIGHT * 2,
-       config::INFO_PANEL_BUTTONS_HEIGHT},
-      gameState.getSecondsElapsed());
+  const auto configButtonSprite = getConfigButtonSprite(gameState);
+  if (configButtonSprite != drawn.configButtonSprite)
+  {
+    drawn.configButtonSprite = configButtonSprite;
+    Blitter::blitOpaque(
+        Sprites::getInstance().getImage(configButtonSprite),
+        Blitter::makeTarget(buff, width),
+        config::getSettings().getConfigButtonX(),
+        config::getSettings().getConfigButtonY());
+    damage.push_back(
+        {config::getSettings().getConfigButtonX(),
+         config::getSettings().getConfigButtonY(),
+         config::INFO_PANEL_BUTTONS_HEIGHT,
+         config::INFO_PANEL_BUTTONS_HEIGHT});
+  }
+
+  const Rect timerRect{
+      config::getSettings().getTimerX(),
+      config::getSettings().getTimerY(),
+      config::INFO_PANEL_BUTTONS_HEIGHT * 2,
+      config::INFO_PANEL_BUTTONS_HEIGHT};
+  if (gameState.getSecondsElapsed() != drawn.secondsElapsed)
+  {
+    drawn.secondsElapsed = gameState.getSecondsElapsed();
+    drawTriDigit(buff, width, timerRect, drawn.secondsElapsed);
+    damage.push_back(timerRect);
+  }
+}
+
+void HeaderArtist::drawFrameStats(
+    std::vector<uint32_t> &buff,
+    const int width,
+    const FrameTimer::Stats &stats,
+    std::vector<Rect> &damage)
+{
+  // row swatches, in Phase order
+  static const std::array<uint32_t, FrameTimer::NUM_PHASES> phaseColors{
+      config::Colors::BLUE, config::Colors::GREEN, config::Colors::YELLOW, config::Colors::PURPLE, config::Colors::WHITE};
+  static const int numDigits = 5;
+
+  // sized like the cell numbers so drawDigit's segment width fits
+  const int digitHeight = 0.4 * config::getSettings().getCellPixelSize();
+  const int digitWidth = digitHeight * 0.6;
+  const int pad = std::max(digitHeight / 6, 1);
+  const int numberWidth = numDigits * (digitWidth + pad);
+  const int rowHeight = digitHeight + 2 * pad;
+
+  const Rect panel{
+      config::getSettings().getGridAreaPadX() + config::FRAME_WIDTH,
+      config::getSettings().getGridAreaPadY() + config::INFO_PANEL_HEIGHT + 2 * config::FRAME_WIDTH,
+      digitHeight + 4 * pad + 3 * (numberWidth + 2 * pad),
+      FrameTimer::NUM_PHASES * rowHeight + 2 * pad};
+
+  // no clipping in the rasterizer, so a minefield too small for the panel just doesn't get one
+  if (panel.w > config::getSettings().getGameAreaWidth() || panel.h > config::getSettings().getGameAreaHeight())
+  {
+    return;
+  }
+
+  BaseArtist::drawRectangle(buff, width, panel, config::Colors::BLACK);
+  damage.push_back(panel);
+
+  for (int phase = 0; phase < FrameTimer::NUM_PHASES; ++phase)
+  {
+    const int y = panel.y + pad + phase * rowHeight + pad;
+    BaseArtist::drawRectangle(buff, width, {panel.x + 2 * pad, y, digitHeight, digitHeight}, phaseColors[phase]);
+
+    const std::array<double, 3> percentiles{stats.p50[phase], stats.p95[phase], stats.p99[phase]};
+    for (int i = 0; i < 3; ++i)
+    {
+      int n = std::min(static_cast<int>(percentiles[i] + 0.5), 99999);
+      const int numberX = panel.x + digitHeight + 4 * pad + i * (numberWidth + 2 * pad);
+      for (int digit = numDigits - 1; digit >= 0; --digit)
+      {
+        drawDigit(
+            buff,
+            width,
+            {numberX + digit * (digitWidth + pad), y, digitWidth, digitHeight},
+            n % 10,
+            config::Colors::RED);
+        n /= 10;
+      }
+    }
+  }
 }
 
 void HeaderArtist::drawRaisedResetButtonSprite(std::vector<uint32_t> &buff, const int width)
@@ -291,24 +381,22 @@ void HeaderArtist::drawGear(std::vector<uint32_t> &buff, const int width, double
   }
 }
 
-const std::vector<uint32_t> &HeaderArtist::getResetButtonSprite(const Minesweeper &gameState)
+SpriteId HeaderArtist::getResetButtonSprite(const Minesweeper &gameState)
 {
   if (gameState.getIsResetButtonPressed())
   {
-    return Sprites::getInstance().get()->pressedResetButton;
+    return SpriteId::PRESSED_RESET_BUTTON;
   }
 
   if (gameState.getIsGameOver())
   {
-    return gameState.getIsGameWon() ? Sprites::getInstance().get()->winnerResetButton
-                                    : Sprites::getInstance().get()->loserResetButton;
+    return gameState.getIsGameWon() ? SpriteId::WINNER_RESET_BUTTON : SpriteId::LOSER_RESET_BUTTON;
   }
 
-  return Sprites::getInstance().get()->raisedResetButton;
+  return SpriteId::RAISED_RESET_BUTTON;
 }
 
-const std::vector<uint32_t> &HeaderArtist::getConfigButtonSprite(const Minesweeper &gameState)
+SpriteId HeaderArtist::getConfigButtonSprite(const Minesweeper &gameState)
 {
-  return gameState.getIsConfigButtonPressed() ? Sprites::getInstance().get()->pressedConfigButton
-                                              : Sprites::getInstance().get()->raisedConfigButton;
+  return gameState.getIsConfigButtonPressed() ? SpriteId::PRESSED_CONFIG_BUTTON : SpriteId::RAISED_CONFIG_BUTTON;
 }
\ No newline at end of file
@@ -1,33 +1,185 @@
+#include <Blitter.hpp>
 #include <FaceArtist.hpp>
 #include <MinefieldArtist.hpp>
 #include <Sprites.hpp>
+#include <ThreadPool.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 
-// private static ints
+namespace
+{
+// the cell sprite table is indexed by a cell's packed byte, offset by this once the game is over
+constexpr int GAME_OVER_OFFSET = 256;
+
+constexpr SpriteId getCellSpriteForState(const uint8_t bits, const bool isGameOver)
+{
+  using Cell = Minesweeper::Cell;
+  const bool isMine = bits & Cell::MINE_BIT;
+  const bool isHidden = bits & Cell::HIDDEN_BIT;
+  const bool isFlagged = bits & Cell::FLAGGED_BIT;
+
+  if (isHidden && !isFlagged)
+  {
+    return SpriteId::HIDDEN;
+  }
+  else if (isHidden && isFlagged && !isMine && isGameOver)
+  {
+    return SpriteId::RED_X_MINE;
+  }
+  else if (isHidden && isFlagged)
+  {
+    return SpriteId::FLAG;
+  }
+  else if (isMine)
+  {
+    return bits & Cell::CLICKED_BIT ? SpriteId::CLICKED_MINE : SpriteId::MINE;
+  }
+
+  const int numAdjacentMines = std::min(bits & Cell::ADJACENT_MINES_MASK, 8);
+  return static_cast<SpriteId>(static_cast<int>(SpriteId::EMPTY) + numAdjacentMines);
+}
+
+constexpr std::array<SpriteId, 2 * GAME_OVER_OFFSET> makeCellSprites()
+{
+  std::array<SpriteId, 2 * GAME_OVER_OFFSET> cellSprites{};
+  for (int i = 0; i < 2 * GAME_OVER_OFFSET; ++i)
+  {
+    cellSprites[i] = getCellSpriteForState(i % GAME_OVER_OFFSET, i >= GAME_OVER_OFFSET);
+  }
+  return cellSprites;
+}
+
+// every state a cell can be in, resolved at compile time, so the raster loop does one load per cell
+constexpr auto CELL_SPRITES = makeCellSprites();
+
+// below this, waking the pool costs more than the cells take to draw
+constexpr int PARALLEL_MIN_CELLS = 1024;
+
+// parallel bands split the minefield between pixel rows, and the frame on either side keeps one row's cells more than a
+// cache line from the next row's, so no two bands ever write to the same cache line
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+static_assert(2 * config::FRAME_WIDTH * sizeof(uint32_t) >= CACHE_LINE_SIZE, "bands would share cache lines");
+
+struct NumericSpriteLayout
+{
+  int height;
+  int width;
+  int pad;
+};
 
-int MinefieldArtist::NUMERIC_SPRITE_HEIGHT = 0.6 * config::getSettings().getCellPixelSize();
-int MinefieldArtist::NUMERIC_SPRITE_WIDTH = NUMERIC_SPRITE_HEIGHT / 2;
-int MinefieldArtist::NUMERIC_SPRITE_PAD = (config::getSettings().getCellPixelSize() - NUMERIC_SPRITE_HEIGHT) / 2;
+// the digit's box within a cell sprite of the given size
+NumericSpriteLayout getNumericSpriteLayout(const int cellPixelSize)
+{
+  const int height = 0.6 * cellPixelSize;
+  return {height, height / 2, (cellPixelSize - height) / 2};
+}
+} // namespace
 
 // public
 
-void MinefieldArtist::updateMinefield(std::vector<uint32_t> &buff, const int width, Minesweeper &gameState)
+void MinefieldArtist::updateMinefield(
+    std::vector<uint32_t> &buff,
+    const int width,
+    Minesweeper &gameState,
+    std::vector<Rect> &damage,
+    ThreadPool *pool,
+    const int numThreads)
 {
   static int gameAreaX = config::getSettings().getGridAreaPadX() + config::FRAME_WIDTH;
   static int gameAreaY = config::getSettings().getGridAreaPadY() + config::INFO_PANEL_HEIGHT + 2 * config::FRAME_WIDTH;
 
-  for (int row = 0; row < config::getSettings().getGridHeight(); ++row)
+  const int gridWidth = gameState.getGridWidth();
+  const int gridHeight = gameState.getGridHeight();
+  int minRow = gridHeight;
+  int maxRow = -1;
+  int minCol = gridWidth;
+  int maxCol = -1;
+
+  const auto &sprites = Sprites::getInstance();
+  const auto target = Blitter::makeTarget(buff, config::getSettings().getGameWindowWidth());
+  const auto &minefield = gameState.getMinefield();
+  const SpriteId *cellSprites = CELL_SPRITES.data() + (gameState.getIsGameOver() ? GAME_OVER_OFFSET : 0);
+
+  const auto drawCell = [&](const int row, const int col)
+  {
+    Blitter::blitOpaque(
+        sprites.getImage(cellSprites[minefield[row * gridWidth + col].getBits()]),
+        target,
+        gameAreaX + col * width,
+        gameAreaY + row * width);
+  };
+
+  // the frame buffer keeps last frame's cells, so only what the engine changed since then is drawn again
+  if (gameState.getIsFullRedrawNeeded())
   {
-    for (int col = 0; col < config::getSettings().getGridWidth(); ++col)
+    const auto drawRows = [&](const int firstRow, const int lastRow)
     {
-      const int cellIndex = row * config::getSettings().getGridWidth() + col;
-      const auto &sprite = getCellSprite(gameState, cellIndex);
+      for (int row = firstRow; row < lastRow; ++row)
+      {
+        for (int col = 0; col < gridWidth; ++col)
+        {
+          drawCell(row, col);
+        }
+      }
+    };
 
-      // could cache these values so they are only calculaated once during construction/init...
-      const int x = gameAreaX + col * width;
-      const int y = gameAreaY + row * width;
-      Sprites::getInstance().copy(sprite, buff, width, x, y);
+    // the calling thread draws the first band while the pool draws the rest; the pool may be shared, so only these
+    // bands are waited for, and any no worker got to yet are drawn here
+    const bool isParallel = pool && gridWidth * gridHeight >= PARALLEL_MIN_CELLS;
+    const int numBands = isParallel ? std::min(numThreads > 0 ? numThreads : pool->getNumThreads() + 1, gridHeight) : 1;
+    if (numBands > 1)
+    {
+      ThreadPool::TaskGroup group(*pool);
+      for (int band = 1; band < numBands; ++band)
+      {
+        group.submit(
+            [&drawRows, band, numBands, gridHeight]
+            { drawRows(band * gridHeight / numBands, (band + 1) * gridHeight / numBands); });
+      }
+      drawRows(0, gridHeight / numBands);
+      group.wait();
+    }
+    else
+    {
+      drawRows(0, gridHeight);
     }
+
+    if (gridWidth * gridHeight > 0)
+    {
+      minRow = 0;
+      maxRow = gridHeight - 1;
+      minCol = 0;
+      maxCol = gridWidth - 1;
+    }
+  }
+  else
+  {
+    for (const int cellIndex : gameState.getDirtyCells())
+    {
+      const int row = cellIndex / gridWidth;
+      const int col = cellIndex % gridWidth;
+      drawCell(row, col);
+
+      minRow = std::min(minRow, row);
+      maxRow = std::max(maxRow, row);
+      minCol = std::min(minCol, col);
+      maxCol = std::max(maxCol, col);
+    }
+  }
+
+  gameState.clearDirtyCells();
+
+  // one bounding rect: a click's changes are local, and one upload beats many small ones
+  if (maxRow >= 0)
+  {
+    damage.push_back(
+        {gameAreaX + minCol * width,
+         gameAreaY + minRow * width,
+         (maxCol - minCol + 1) * width,
+         (maxRow - minRow + 1) * width});
   }
 };
 
@@ -74,13 +226,11 @@ void MinefieldArtist::drawNumericSprite(std::vector<uint32_t> &buff, const int w
   draw2DCellBase(buff, width);
   if (n != 1)
   {
+    const auto layout = getNumericSpriteLayout(width);
     drawDigit(
         buff,
         width,
-        {width / 2 - NUMERIC_SPRITE_WIDTH / 2,
-         width / 2 - NUMERIC_SPRITE_HEIGHT / 2,
-         NUMERIC_SPRITE_WIDTH,
-         NUMERIC_SPRITE_HEIGHT},
+        {width / 2 - layout.width / 2, width / 2 - layout.height / 2, layout.width, layout.height},
         n,
         c);
   }
@@ -90,6 +240,12 @@ void MinefieldArtist::drawNumericSprite(std::vector<uint32_t> &buff, const int w
   }
 };
 
+SpriteId MinefieldArtist::getCellSprite(const Minesweeper &gameState, const int cellIndex)
+{
+  const int offset = gameState.getIsGameOver() ? GAME_OVER_OFFSET : 0;
+  return CELL_SPRITES[offset + gameState.getMinefield()[cellIndex].getBits()];
+};
+
 // private
 
 void MinefieldArtist::drawMine(std::vector<uint32_t> &buff, const int width)
@@ -201,67 +357,36 @@ void MinefieldArtist::drawFlag(std::vector<uint32_t> &buff, const int width)
 
 void MinefieldArtist::drawOne(std::vector<uint32_t> &buff, const int width)
 {
+  const auto layout = getNumericSpriteLayout(width);
+
   std::vector<uint32_t> sprite;
-  sprite.resize(NUMERIC_SPRITE_HEIGHT * NUMERIC_SPRITE_HEIGHT);
-  std::fill_n(sprite.begin(), NUMERIC_SPRITE_HEIGHT * NUMERIC_SPRITE_HEIGHT, config::Colors::GREY);
+  sprite.resize(layout.height * layout.height);
+  std::fill_n(sprite.begin(), layout.height * layout.height, config::Colors::GREY);
 
   // base
-  const int baseHeight = 0.15 * NUMERIC_SPRITE_HEIGHT;
-  const int baseWidth = NUMERIC_SPRITE_WIDTH;
-  const int baseLeftPad = (NUMERIC_SPRITE_HEIGHT - baseWidth) / 2;
+  const int baseHeight = 0.15 * layout.height;
+  const int baseWidth = layout.width;
+  const int baseLeftPad = (layout.height - baseWidth) / 2;
   BaseArtist::drawRectangle(
       sprite,
-      NUMERIC_SPRITE_HEIGHT,
-      {baseLeftPad, NUMERIC_SPRITE_HEIGHT - baseHeight, baseWidth, baseHeight},
+      layout.height,
+      {baseLeftPad, layout.height - baseHeight, baseWidth, baseHeight},
       config::Colors::BLUE);
 
   // stem
-  const int stemWidth = 0.15 * NUMERIC_SPRITE_HEIGHT;
-  const int stemLeftPad = (NUMERIC_SPRITE_HEIGHT - stemWidth) / 2;
-  BaseArtist::drawRectangle(
-      sprite, NUMERIC_SPRITE_HEIGHT, {stemLeftPad, 0, stemWidth, NUMERIC_SPRITE_HEIGHT}, config::Colors::BLUE);
+  const int stemWidth = 0.15 * layout.height;
+  const int stemLeftPad = (layout.height - stemWidth) / 2;
+  BaseArtist::drawRectangle(sprite, layout.height, {stemLeftPad, 0, stemWidth, layout.height}, config::Colors::BLUE);
 
   // topper
-  const int topperWidth = 0.2 * NUMERIC_SPRITE_HEIGHT;
-  const int topperHeight = 0.15 * NUMERIC_SPRITE_HEIGHT;
+  const int topperWidth = 0.2 * layout.height;
+  const int topperHeight = 0.15 * layout.height;
   const int topperX = stemLeftPad - topperWidth;
-  BaseArtist::drawRectangle(
-      sprite, NUMERIC_SPRITE_HEIGHT, {topperX, 0, topperWidth, topperHeight}, config::Colors::BLUE);
+  BaseArtist::drawRectangle(sprite, layout.height, {topperX, 0, topperWidth, topperHeight}, config::Colors::BLUE);
 
-  for (int i = 0; i < NUMERIC_SPRITE_HEIGHT; ++i)
-  {
-    const auto spriteStart = sprite.begin() + i * NUMERIC_SPRITE_HEIGHT;
-    const auto spriteEnd = sprite.begin() + i * NUMERIC_SPRITE_HEIGHT + NUMERIC_SPRITE_HEIGHT;
-    const int buffIdx = ((i + NUMERIC_SPRITE_PAD) * width) + NUMERIC_SPRITE_PAD;
-    std::copy(spriteStart, spriteEnd, buff.begin() + buffIdx);
-  }
+  Blitter::blitOpaque(
+      {sprite.data(), layout.height, layout.height, layout.height},
+      Blitter::makeTarget(buff, width),
+      layout.pad,
+      layout.pad);
 }
-
-const std::vector<uint32_t> &MinefieldArtist::getCellSprite(const Minesweeper &gameState, const int cellIndex)
-{
-  const auto &[isMine, isHidden, isFlagged, isClicked, nAdjacentMines] = gameState.getMinefield()[cellIndex];
-
-  if (isHidden && !isFlagged)
-  {
-    return Sprites::getInstance().get()->hidden;
-  }
-  else if (isHidden && isFlagged && !isMine && gameState.getIsGameOver())
-  {
-    return Sprites::getInstance().get()->redXMine;
-  }
-  else if (isHidden && isFlagged)
-  {
-    return Sprites::getInstance().get()->flag;
-  }
-  else
-  {
-    if (isMine)
-    {
-      return isClicked ? Sprites::getInstance().get()->clickedMine : Sprites::getInstance().get()->mine;
-    }
-    else
-    {
-      return Sprites::getInstance().get()->intToSpriteMap.at(nAdjacentMines);
-    }
-  }
-};
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include <Blitter.hpp>
+#include <MinefieldArtist.hpp>
+#include <SpriteAtlas.hpp>
+#include <Sprites.hpp>
+#include <cmath>
+#include <config.hpp>
+#include <cstdint>
+#include <vector>
+
+SpriteAtlas::SpriteAtlas()
+{
+  const auto &sprites = Sprites::getInstance();
+  const int firstCellSprite = static_cast<int>(Sprites::FIRST_CELL_SPRITE);
+  const int numCellSprites = static_cast<int>(Sprites::LAST_CELL_SPRITE) - firstCellSprite + 1;
+
+  // a square-ish grid keeps the texture within the GPU's size limits even for big cells
+  const int cellPixelSize = config::getSettings().getCellPixelSize();
+  const int numCols = static_cast<int>(std::ceil(std::sqrt(numCellSprites)));
+  const int numRows = (numCellSprites + numCols - 1) / numCols;
+  width = numCols * cellPixelSize;
+  height = numRows * cellPixelSize;
+  pixels.assign(width * height, config::Colors::BLACK);
+
+  for (int i = 0; i < numCellSprites; ++i)
+  {
+    const auto id = static_cast<SpriteId>(firstCellSprite + i);
+    const Rect rect{(i % numCols) * cellPixelSize, (i / numCols) * cellPixelSize, cellPixelSize, cellPixelSize};
+    Blitter::blitOpaque(sprites.getImage(id), Blitter::makeTarget(pixels, width), rect.x, rect.y);
+    spriteRects[firstCellSprite + i] = rect;
+  }
+}
+
+void SpriteAtlas::appendMinefieldCopies(const Minesweeper &gameState, std::vector<Copy> &copies) const
+{
+  const int cellPixelSize = config::getSettings().getCellPixelSize();
+  const int gameAreaX = config::getSettings().getGridAreaPadX() + config::FRAME_WIDTH;
+  const int gameAreaY = config::getSettings().getGridAreaPadY() + config::INFO_PANEL_HEIGHT + 2 * config::FRAME_WIDTH;
+
+  for (int row = 0; row < gameState.getGridHeight(); ++row)
+  {
+    for (int col = 0; col < gameState.getGridWidth(); ++col)
+    {
+      const auto sprite = MinefieldArtist::getCellSprite(gameState, row * gameState.getGridWidth() + col);
+      copies.push_back(
+          {spriteRects[static_cast<int>(sprite)],
+           {gameAreaX + col * cellPixelSize, gameAreaY + row * cellPixelSize, cellPixelSize, cellPixelSize}});
+    }
+  }
+}
@@ -0,0 +1,38 @@
+#include <FrameScheduler.hpp>
+#include <Minesweeper.hpp>
+#include <SDL2/SDL.h>
+#include <vector>
+
+void FrameScheduler::handleEvent(const SDL_Event &event)
+{
+  for (auto *window : windows)
+  {
+    const bool isExposed = event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_EXPOSED &&
+                           event.window.windowID == window->getWindowID();
+    if (isExposed || event.type == SDL_RENDER_TARGETS_RESET)
+    {
+      window->invalidate();
+    }
+  }
+}
+
+void FrameScheduler::render(Minesweeper &game)
+{
+  changedWindows.clear();
+  for (auto *window : windows)
+  {
+    if (window->update(game))
+    {
+      changedWindows.push_back(window);
+    }
+  }
+}
+
+void FrameScheduler::present()
+{
+  for (auto *window : changedWindows)
+  {
+    window->present();
+  }
+  changedWindows.clear();
+}
@@ -0,0 +1,120 @@
+#include <FrameTimer.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace
+{
+int toIndex(const FrameTimer::Phase phase) { return static_cast<int>(phase); }
+} // namespace
+
+FrameTimer::FrameTimer(const std::string &csvPath)
+{
+  window.reserve(WINDOW_SIZE);
+  scratch.reserve(WINDOW_SIZE);
+
+  if (!csvPath.empty())
+  {
+    csv.open(csvPath);
+    csv << "frame,events_us,timer_us,draw_us,present_us,frame_us\n";
+  }
+}
+
+FrameTimer::~FrameTimer()
+{
+  // flushes the frames not yet collected to the CSV
+  collect();
+}
+
+void FrameTimer::startFrame()
+{
+  current.frameIndex = numFrames++;
+  current.microseconds.fill(0);
+  lastMark = Clock::now();
+}
+
+void FrameTimer::mark(const Phase phase)
+{
+  const auto now = Clock::now();
+  current.microseconds[toIndex(phase)] += std::chrono::duration<float, std::micro>(now - lastMark).count();
+  lastMark = now;
+}
+
+void FrameTimer::endFrame()
+{
+  float total = 0;
+  for (int i = 0; i < toIndex(Phase::FRAME); ++i)
+  {
+    total += current.microseconds[i];
+  }
+  current.microseconds[toIndex(Phase::FRAME)] = total;
+
+  if (!ring.push(current))
+  {
+    numDroppedFrames.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void FrameTimer::collect()
+{
+  Sample sample;
+  bool hasNewSamples = false;
+  while (ring.pop(sample))
+  {
+    hasNewSamples = true;
+
+    if (window.size() < WINDOW_SIZE)
+    {
+      window.push_back(sample);
+    }
+    else
+    {
+      window[windowIndex] = sample;
+      windowIndex = (windowIndex + 1) % WINDOW_SIZE;
+    }
+
+    if (csv.is_open())
+    {
+      csv << sample.frameIndex;
+      for (const auto microseconds : sample.microseconds)
+      {
+        csv << "," << microseconds;
+      }
+      csv << "\n";
+    }
+  }
+
+  if (hasNewSamples)
+  {
+    updateStats();
+  }
+}
+
+void FrameTimer::updateStats()
+{
+  // nearest-rank percentile, the order of the window doesn't matter
+  const auto getPercentile = [this](const double p)
+  {
+    const auto rank = static_cast<std::size_t>(std::ceil(p * scratch.size()));
+    const auto nth = scratch.begin() + std::max<std::size_t>(rank, 1) - 1;
+    std::nth_element(scratch.begin(), nth, scratch.end());
+    return static_cast<double>(*nth);
+  };
+
+  for (int phase = 0; phase < NUM_PHASES; ++phase)
+  {
+    scratch.clear();
+    for (const auto &sample : window)
+    {
+      scratch.push_back(sample.microseconds[phase]);
+    }
+
+    stats.p50[phase] = getPercentile(0.50);
+    stats.p95[phase] = getPercentile(0.95);
+    stats.p99[phase] = getPercentile(0.99);
+  }
+  stats.numFrames = static_cast<int>(window.size());
+}
@@ -1,7 +1,50 @@
+#include <FrameTimer.hpp>
 #include <GameLoop.hpp>
 #include <SDL2/SDL.h>
+#include <Sprites.hpp>
+#include <algorithm>
+#include <chrono>
+#include <config.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
 
-GameLoop::GameLoop(Minesweeper &g, Renderer &r) : game(g), renderer(r) {}
+namespace
+{
+const char *getFrameTimesPath()
+{
+  const char *path = std::getenv("MINESWEEPER_FRAME_TIMES");
+  return path ? path : "";
+}
+
+bool getIsStartupReported()
+{
+  const char *value = std::getenv("MINESWEEPER_STARTUP_TIMES");
+  return value && *value && std::string(value) != "0";
+}
+
+double toMilliseconds(const std::chrono::steady_clock::duration duration)
+{
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+} // namespace
+
+GameLoop::GameLoop(Minesweeper &g, Renderer &r, const std::chrono::steady_clock::time_point t)
+    : game(g),
+      renderer(r),
+      isEventDriven(config::getSettings().getEventDriven()),
+      frameTimer(getFrameTimesPath()),
+      isStartupReported(getIsStartupReported()),
+      startTime(t)
+{
+  renderer.getGameWindow().setFrameTimer(&frameTimer);
+
+  // the game window goes first, so its latency doesn't depend on the settings window
+  frameScheduler.addWindow(renderer.getGameWindow());
+  frameScheduler.addWindow(renderer.getSettingsWindow());
+}
 
 void GameLoop::run()
 {
@@ -9,16 +52,49 @@ void GameLoop::run()
 
   Uint32 lastTime = SDL_GetTicks();
   Uint32 timerAccumulator = 0;
+  uint64_t numFrames = 0;
+
+  // the barrier for Sprites::startBaking, before the first update draws with them
+  const auto spritesWaitStart = std::chrono::steady_clock::now();
+  Sprites::getInstance();
+  const auto spritesWait = std::chrono::steady_clock::now() - spritesWaitStart;
 
   while (isRunning)
   {
+    // sleeps until there is something to do, which replaces the fixed-rate limitFPS below; the first frame is drawn
+    // right away
+    if (isEventDriven && numFrames > 0)
+    {
+      waitForEvent(lastTime, timerAccumulator);
+    }
+
     auto frameStart = SDL_GetTicks();
+    frameTimer.startFrame();
 
     handleEvents();
+    frameTimer.mark(FrameTimer::Phase::EVENTS);
     updateTimer(lastTime, timerAccumulator);
+    frameTimer.mark(FrameTimer::Phase::TIMER);
     render();
-    limitFPS(frameStart);
+    frameTimer.endFrame();
+
+    if (numFrames == 0 && isStartupReported)
+    {
+      reportStartup(spritesWait);
+    }
+
+    if (++numFrames % frameStatsInterval == 0)
+    {
+      frameTimer.collect();
+    }
+
+    if (!isEventDriven)
+    {
+      limitFPS(frameStart);
+    }
   }
+
+  frameTimer.collect();
 }
 
 void GameLoop::handleEvents()
@@ -26,20 +102,54 @@ void GameLoop::handleEvents()
   SDL_Event event;
   while (SDL_PollEvent(&event))
   {
-    if (event.type == SDL_QUIT)
-    {
-      isRunning = false;
-    }
+    handleEvent(event);
+  }
+}
 
-    if (event.window.windowID == renderer.getGameWindow().getWindowID())
-    {
-      renderer.getGameWindow().handleEvent(event, game, isRunning);
-    }
+void GameLoop::waitForEvent(const Uint32 lastTime, const Uint32 timerAccumulator)
+{
+  // the header timer is the only thing that changes on its own, and only while a game is running and visible; a
+  // minimized window catches up on the seconds it missed in updateTimer once it wakes
+  const bool isMinimized = SDL_GetWindowFlags(renderer.getGameWindow().getWindow()) & SDL_WINDOW_MINIMIZED;
+  int timeoutMs = -1;
+  if (!game.getIsGameOver() && !isMinimized)
+  {
+    const int msSinceTick = timerAccumulator + (SDL_GetTicks() - lastTime);
+    timeoutMs = std::max(oneSecondMs - msSinceTick, 0);
+  }
 
-    if (event.window.windowID == renderer.getSettingsWindow().getWindowID())
-    {
-      renderer.getSettingsWindow().handleEvent(event);
-    }
+  // -1 waits indefinitely; a null event leaves the one that arrived queued, so handleEvents() picks it up inside the
+  // timed frame and its work counts towards the events phase
+  SDL_WaitEventTimeout(nullptr, timeoutMs);
+}
+
+void GameLoop::handleEvent(SDL_Event &event)
+{
+  if (event.type == SDL_QUIT)
+  {
+    isRunning = false;
+  }
+
+  frameScheduler.handleEvent(event);
+
+  if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F3)
+  {
+    renderer.getGameWindow().setShowFrameStats(!renderer.getGameWindow().getShowFrameStats());
+  }
+
+  if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F4)
+  {
+    renderer.getGameWindow().setUseSpriteAtlas(!renderer.getGameWindow().getUseSpriteAtlas());
+  }
+
+  if (event.window.windowID == renderer.getGameWindow().getWindowID())
+  {
+    renderer.getGameWindow().handleEvent(event, game, isRunning);
+  }
+
+  if (event.window.windowID == renderer.getSettingsWindow().getWindowID())
+  {
+    renderer.getSettingsWindow().handleEvent(event);
   }
 }
 
@@ -50,8 +160,6 @@ void GameLoop::updateTimer(Uint32 &lastTime, Uint32 &timerAccumulator)
     return;
   }
 
-  static const int oneSecondMs = 1000;
-
   auto currentTime = SDL_GetTicks();
   timerAccumulator += currentTime - lastTime;
   while (timerAccumulator >= oneSecondMs)
@@ -64,9 +172,22 @@ void GameLoop::updateTimer(Uint32 &lastTime, Uint32 &timerAccumulator)
 
 void GameLoop::render()
 {
-  renderer.getGameWindow().update(game);
-  renderer.getSettingsWindow().update(game);
-  renderer.getGameWindow().update(game);
+  frameScheduler.render(game);
+  frameTimer.mark(FrameTimer::Phase::DRAW);
+  // blocks until vblank when the game window changed, hence its own phase
+  frameScheduler.present();
+  frameTimer.mark(FrameTimer::Phase::PRESENT);
+}
+
+void GameLoop::reportStartup(const std::chrono::steady_clock::duration spritesWait) const
+{
+  const auto &sprites = Sprites::getInstance();
+  const double firstFrameMs = toMilliseconds(std::chrono::steady_clock::now() - startTime);
+
+  // the sprites overlap window creation, so only the part the barrier waited for adds to the first frame
+  std::cout << std::fixed << std::setprecision(2) << "first frame after " << firstFrameMs << " ms; sprites "
+            << (sprites.getIsCached() ? "mapped" : "drawn") << " in " << toMilliseconds(sprites.getBakeTime())
+            << " ms, waited " << toMilliseconds(spritesWait) << " ms for them" << std::endl;
 }
 
 void GameLoop::limitFPS(Uint32 &frameStart)
@@ -0,0 +1,330 @@
+#include <InfiniteMinesweeper.hpp>
+#include <MineCounter.hpp>
+#include <Minesweeper.hpp>
+#include <Random.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+// splitmix64's finalizer
+uint64_t mix(uint64_t z)
+{
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+// keeps revealedCells from holding on to a huge flood fill's worth of memory for the rest of the game
+constexpr std::size_t MAX_KEPT_REVEALED_CELLS = 1 << 12;
+} // namespace
+
+InfiniteMinesweeper::InfiniteMinesweeper(const uint64_t s, const double mineDensity)
+    : seed(s), minesPerChunk(std::clamp(
+                   static_cast<int>(std::lround(mineDensity * CHUNK_SIZE * CHUNK_SIZE)), 0, CHUNK_SIZE * CHUNK_SIZE))
+{
+}
+
+Minesweeper::Cell InfiniteMinesweeper::getCell(const int64_t row, const int64_t col) const
+{
+  const auto it = chunks.find({toChunkCoord(row), toChunkCoord(col)});
+  if (it == chunks.end())
+  {
+    return Minesweeper::Cell{};
+  }
+  return it->second.cells[toLocalIndex(row, col)];
+}
+
+void InfiniteMinesweeper::handleLeftClick(const int64_t row, const int64_t col)
+{
+  clearRevealedCells();
+
+  if (isGameOver)
+  {
+    return;
+  }
+
+  // chunks are only generated once the first click, and so the safe zone around it, is known
+  if (isFirstClick)
+  {
+    isFirstClick = false;
+    firstClick = {row, col};
+  }
+
+  // clicking a revealed cell picks up where a cut short flood fill left off
+  if (!getCountedCell(row, col).getIsHidden())
+  {
+    floodFillEmptyCells();
+    return;
+  }
+
+  revealCell(row, col);
+}
+
+void InfiniteMinesweeper::handleRightClick(const int64_t row, const int64_t col)
+{
+  clearRevealedCells();
+
+  if (isGameOver || isFirstClick)
+  {
+    return;
+  }
+
+  auto &cell = getCountedCell(row, col);
+  if (!cell.getIsHidden())
+  {
+    return;
+  }
+
+  cell.setIsFlagged(!cell.getIsFlagged());
+  numFlags += cell.getIsFlagged() ? 1 : -1;
+}
+
+void InfiniteMinesweeper::handleMiddleClick(const int64_t row, const int64_t col)
+{
+  clearRevealedCells();
+
+  if (isGameOver || isFirstClick || getCountedCell(row, col).getIsHidden())
+  {
+    return;
+  }
+
+  int numAdjacentFlags = 0;
+  for (const auto &[dRow, dCol] : ADJACENCY_OFFSETS)
+  {
+    numAdjacentFlags += getCountedCell(row + dRow, col + dCol).getIsFlagged();
+  }
+
+  if (numAdjacentFlags != getCountedCell(row, col).getNumAdjacentMines())
+  {
+    return;
+  }
+
+  for (const auto &[dRow, dCol] : ADJACENCY_OFFSETS)
+  {
+    revealCell(row + dRow, col + dCol);
+  }
+}
+
+void InfiniteMinesweeper::continueFloodFill()
+{
+  clearRevealedCells();
+
+  if (!isGameOver)
+  {
+    floodFillEmptyCells();
+  }
+}
+
+void InfiniteMinesweeper::reset(const uint64_t newSeed)
+{
+  seed = newSeed;
+  firstClick = {0, 0};
+  chunks.clear();
+  clearRevealedCells();
+  floodFrontier.clear();
+  numRevealedCells = 0;
+  numFlags = 0;
+  isGameOver = false;
+  isFirstClick = true;
+}
+
+// private
+
+int InfiniteMinesweeper::toLocalIndex(const int64_t row, const int64_t col)
+{
+  const int localRow = static_cast<int>(row - toChunkCoord(row) * CHUNK_SIZE);
+  const int localCol = static_cast<int>(col - toChunkCoord(col) * CHUNK_SIZE);
+  return localRow * CHUNK_SIZE + localCol;
+}
+
+uint64_t InfiniteMinesweeper::getChunkHash(const ChunkCoord &coord)
+{
+  return mix(mix(static_cast<uint64_t>(coord.row)) ^ static_cast<uint64_t>(coord.col));
+}
+
+InfiniteMinesweeper::Chunk &InfiniteMinesweeper::getMinedChunk(const int64_t chunkRow, const int64_t chunkCol)
+{
+  const ChunkCoord coord = {chunkRow, chunkCol};
+  auto [it, isNew] = chunks.try_emplace(coord);
+  auto &chunk = it->second;
+  if (!isNew)
+  {
+    return chunk;
+  }
+
+  // every chunk draws from its own stream, so the board doesn't depend on the order chunks are visited in
+  Random random(seed ^ (getChunkHash(coord) * 0x9e3779b97f4a7c15));
+  const int numCells = CHUNK_SIZE * CHUNK_SIZE;
+  for (int j = numCells - minesPerChunk; j < numCells; ++j)
+  {
+    int index = random.nextBelow(j + 1);
+    if (chunk.cells[index].getIsMine())
+    {
+      index = j;
+    }
+    chunk.cells[index].setIsMine(true);
+  }
+
+  // keep the first click's neighbourhood clear, as the bounded board does
+  for (int dRow = -1; dRow <= 1; ++dRow)
+  {
+    for (int dCol = -1; dCol <= 1; ++dCol)
+    {
+      const int64_t row = firstClick.row + dRow;
+      const int64_t col = firstClick.col + dCol;
+      if (toChunkCoord(row) == chunkRow && toChunkCoord(col) == chunkCol)
+      {
+        chunk.cells[toLocalIndex(row, col)].setIsMine(false);
+      }
+    }
+  }
+
+  return chunk;
+}
+
+InfiniteMinesweeper::Chunk &InfiniteMinesweeper::getCountedChunk(const int64_t chunkRow, const int64_t chunkCol)
+{
+  auto &chunk = getMinedChunk(chunkRow, chunkCol);
+  if (chunk.isCounted)
+  {
+    return chunk;
+  }
+
+  // unordered_map nodes are stable, so these survive the neighbours being generated
+  std::array<const Chunk *, 9> neighbourhood;
+  for (int dRow = -1; dRow <= 1; ++dRow)
+  {
+    for (int dCol = -1; dCol <= 1; ++dCol)
+    {
+      neighbourhood[(dRow + 1) * 3 + dCol + 1] = &getMinedChunk(chunkRow + dRow, chunkCol + dCol);
+    }
+  }
+
+  // the chunk plus a one cell border taken from its neighbours, box-summed in one go
+  const int size = CHUNK_SIZE + 2;
+  countBuffer.resize(size * size);
+  for (int y = 0; y < size; ++y)
+  {
+    const int localRow = y - 1;
+    const int dRow = localRow < 0 ? -1 : (localRow >= CHUNK_SIZE ? 1 : 0);
+    for (int x = 0; x < size; ++x)
+    {
+      const int localCol = x - 1;
+      const int dCol = localCol < 0 ? -1 : (localCol >= CHUNK_SIZE ? 1 : 0);
+      const auto *source = neighbourhood[(dRow + 1) * 3 + dCol + 1];
+      const auto &cell =
+          source->cells[(localRow - dRow * CHUNK_SIZE) * CHUNK_SIZE + (localCol - dCol * CHUNK_SIZE)];
+      countBuffer[y * size + x] = *reinterpret_cast<const uint8_t *>(&cell);
+    }
+  }
+
+  mineCounter.countAdjacentMines(countBuffer.data(), size, size);
+
+  auto *cells = reinterpret_cast<uint8_t *>(chunk.cells.data());
+  for (int row = 0; row < CHUNK_SIZE; ++row)
+  {
+    for (int col = 0; col < CHUNK_SIZE; ++col)
+    {
+      auto &bits = cells[row * CHUNK_SIZE + col];
+      const uint8_t count = countBuffer[(row + 1) * size + col + 1] & Minesweeper::Cell::ADJACENT_MINES_MASK;
+      bits = (bits & ~Minesweeper::Cell::ADJACENT_MINES_MASK) | count;
+    }
+  }
+
+  chunk.isCounted = true;
+  return chunk;
+}
+
+Minesweeper::Cell &InfiniteMinesweeper::getCountedCell(const int64_t row, const int64_t col)
+{
+  return getCountedChunk(toChunkCoord(row), toChunkCoord(col)).cells[toLocalIndex(row, col)];
+}
+
+void InfiniteMinesweeper::clearRevealedCells()
+{
+  if (revealedCells.capacity() > MAX_KEPT_REVEALED_CELLS)
+  {
+    revealedCells = {};
+  }
+  revealedCells.clear();
+}
+
+void InfiniteMinesweeper::revealCell(const int64_t row, const int64_t col)
+{
+  auto &cell = getCountedCell(row, col);
+  if (cell.getIsFlagged() || !cell.getIsHidden())
+  {
+    return;
+  }
+  cell.setIsHidden(false);
+  revealedCells.push_back({row, col});
+  ++numRevealedCells;
+
+  if (cell.getIsMine())
+  {
+    isGameOver = true;
+    cell.setIsClicked(true);
+    floodFrontier.clear();
+    revealGeneratedMines();
+    return;
+  }
+
+  if (cell.getNumAdjacentMines() == 0)
+  {
+    floodFrontier.push_back({row, col});
+    floodFillEmptyCells();
+  }
+}
+
+void InfiniteMinesweeper::floodFillEmptyCells()
+{
+  // breadth-first from the frontier, with the hidden bit as the visited set; a cell's neighbours are revealed all
+  // together or not at all, so whatever is left in the frontier is exactly what a later call has to carry on from
+  while (!floodFrontier.empty() && revealedCells.size() + ADJACENCY_OFFSETS.size() <= MAX_REVEALED_CELLS_PER_CLICK)
+  {
+    const auto [row, col] = floodFrontier.front();
+    floodFrontier.pop_front();
+
+    for (const auto &[dRow, dCol] : ADJACENCY_OFFSETS)
+    {
+      auto &cell = getCountedCell(row + dRow, col + dCol);
+      if (!cell.getIsHidden() || cell.getIsMine())
+      {
+        continue;
+      }
+
+      if (cell.getIsFlagged())
+      {
+        cell.setIsFlagged(false);
+        --numFlags;
+      }
+      cell.setIsHidden(false);
+      revealedCells.push_back({row + dRow, col + dCol});
+      ++numRevealedCells;
+
+      if (cell.getNumAdjacentMines() == 0)
+      {
+        floodFrontier.push_back({row + dRow, col + dCol});
+      }
+    }
+  }
+}
+
+void InfiniteMinesweeper::revealGeneratedMines()
+{
+  for (auto &[coord, chunk] : chunks)
+  {
+    for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; ++i)
+    {
+      auto &cell = chunk.cells[i];
+      if (cell.getIsMine() && cell.getIsHidden())
+      {
+        cell.setIsHidden(false);
+        revealedCells.push_back({coord.row * CHUNK_SIZE + i / CHUNK_SIZE, coord.col * CHUNK_SIZE + i % CHUNK_SIZE});
+      }
+    }
+  }
+}
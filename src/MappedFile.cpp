@@ -0,0 +1,81 @@
+#include <MappedFile.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+#ifdef _WIN32
+#define MAPPED_FILE_READ_FALLBACK
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::unique_ptr<MappedFile> MappedFile::open(const std::filesystem::path &path)
+{
+  std::unique_ptr<MappedFile> file(new MappedFile());
+
+#ifdef MAPPED_FILE_READ_FALLBACK
+  std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+  if (!ifs)
+  {
+    return nullptr;
+  }
+
+  const auto size = static_cast<std::size_t>(ifs.tellg());
+  if (size == 0)
+  {
+    return nullptr;
+  }
+
+  file->contents.resize((size + sizeof(CacheLine) - 1) / sizeof(CacheLine));
+  ifs.seekg(0);
+  if (!ifs.read(reinterpret_cast<char *>(file->contents.data()), size))
+  {
+    return nullptr;
+  }
+
+  file->data = file->contents.front().bytes;
+  file->size = size;
+#else
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return nullptr;
+  }
+
+  struct stat status;
+  if (fstat(fd, &status) != 0 || status.st_size <= 0)
+  {
+    close(fd);
+    return nullptr;
+  }
+
+  // the mapping keeps its own reference to the file, so the descriptor isn't needed past this
+  void *mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    return nullptr;
+  }
+
+  file->data = static_cast<const uint8_t *>(mapping);
+  file->size = status.st_size;
+  file->isMapped = true;
+#endif
+
+  return file;
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef MAPPED_FILE_READ_FALLBACK
+  if (isMapped)
+  {
+    munmap(const_cast<uint8_t *>(data), size);
+  }
+#endif
+}
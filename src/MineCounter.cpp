@@ -0,0 +1,216 @@
+#include <MineCounter.hpp>
+#include <Minesweeper.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MINE_COUNTER_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+constexpr int MINE_SHIFT = 4;
+static_assert(Minesweeper::Cell::MINE_BIT == 1 << MINE_SHIFT, "kernels assume the mine flag is bit 4");
+static_assert(Minesweeper::Cell::ADJACENT_MINES_MASK == 0x0f, "kernels assume the count is the low nibble");
+
+struct Kernels
+{
+  // mines[x] = mine bit of cells[x]
+  void (*extractMines)(const uint8_t *cells, uint8_t *mines, const int width);
+  // sums[x] = paddedMines[x] + paddedMines[x + 1] + paddedMines[x + 2]
+  void (*sumRow)(const uint8_t *paddedMines, uint8_t *sums, const int width);
+  // low nibble of cells[x] = above[x] + row[x] + below[x] - mine bit of cells[x]
+  void (*combineRows)(uint8_t *cells, const uint8_t *above, const uint8_t *row, const uint8_t *below, const int width);
+  const char *name;
+};
+
+// scalar
+
+void extractMinesScalar(const uint8_t *cells, uint8_t *mines, const int begin, const int width)
+{
+  for (int x = begin; x < width; ++x)
+  {
+    mines[x] = (cells[x] >> MINE_SHIFT) & 1;
+  }
+}
+
+void sumRowScalar(const uint8_t *paddedMines, uint8_t *sums, const int begin, const int width)
+{
+  for (int x = begin; x < width; ++x)
+  {
+    sums[x] = paddedMines[x] + paddedMines[x + 1] + paddedMines[x + 2];
+  }
+}
+
+void combineRowsScalar(
+    uint8_t *cells,
+    const uint8_t *above,
+    const uint8_t *row,
+    const uint8_t *below,
+    const int begin,
+    const int width)
+{
+  for (int x = begin; x < width; ++x)
+  {
+    const uint8_t count = above[x] + row[x] + below[x] - ((cells[x] >> MINE_SHIFT) & 1);
+    cells[x] = (cells[x] & ~Minesweeper::Cell::ADJACENT_MINES_MASK) | count;
+  }
+}
+
+const Kernels SCALAR_KERNELS = {
+    [](const uint8_t *cells, uint8_t *mines, const int width) { extractMinesScalar(cells, mines, 0, width); },
+    [](const uint8_t *paddedMines, uint8_t *sums, const int width) { sumRowScalar(paddedMines, sums, 0, width); },
+    [](uint8_t *cells, const uint8_t *above, const uint8_t *row, const uint8_t *below, const int width)
+    { combineRowsScalar(cells, above, row, below, 0, width); },
+    "scalar",
+};
+
+#ifdef MINE_COUNTER_X86
+
+// sse2
+
+__attribute__((target("sse2"))) void extractMinesSSE2(const uint8_t *cells, uint8_t *mines, const int width)
+{
+  const __m128i one = _mm_set1_epi8(1);
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(cells + x));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(mines + x), _mm_and_si128(_mm_srli_epi16(v, MINE_SHIFT), one));
+  }
+  extractMinesScalar(cells, mines, x, width);
+}
+
+__attribute__((target("sse2"))) void sumRowSSE2(const uint8_t *paddedMines, uint8_t *sums, const int width)
+{
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    const __m128i left = _mm_loadu_si128(reinterpret_cast<const __m128i *>(paddedMines + x));
+    const __m128i middle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(paddedMines + x + 1));
+    const __m128i right = _mm_loadu_si128(reinterpret_cast<const __m128i *>(paddedMines + x + 2));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(sums + x), _mm_add_epi8(_mm_add_epi8(left, middle), right));
+  }
+  sumRowScalar(paddedMines, sums, x, width);
+}
+
+__attribute__((target("sse2"))) void
+combineRowsSSE2(uint8_t *cells, const uint8_t *above, const uint8_t *row, const uint8_t *below, const int width)
+{
+  const __m128i one = _mm_set1_epi8(1);
+  const __m128i stateMask = _mm_set1_epi8(static_cast<char>(~Minesweeper::Cell::ADJACENT_MINES_MASK));
+  int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(cells + x));
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(above + x));
+    const __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(below + x));
+    const __m128i mine = _mm_and_si128(_mm_srli_epi16(v, MINE_SHIFT), one);
+    const __m128i count = _mm_sub_epi8(_mm_add_epi8(_mm_add_epi8(a, r), b), mine);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(cells + x), _mm_or_si128(_mm_and_si128(v, stateMask), count));
+  }
+  combineRowsScalar(cells, above, row, below, x, width);
+}
+
+const Kernels SSE2_KERNELS = {extractMinesSSE2, sumRowSSE2, combineRowsSSE2, "sse2"};
+
+// avx2
+
+__attribute__((target("avx2"))) void extractMinesAVX2(const uint8_t *cells, uint8_t *mines, const int width)
+{
+  const __m256i one = _mm256_set1_epi8(1);
+  int x = 0;
+  for (; x + 32 <= width; x += 32)
+  {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(cells + x));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(mines + x), _mm256_and_si256(_mm256_srli_epi16(v, MINE_SHIFT), one));
+  }
+  extractMinesScalar(cells, mines, x, width);
+}
+
+__attribute__((target("avx2"))) void sumRowAVX2(const uint8_t *paddedMines, uint8_t *sums, const int width)
+{
+  int x = 0;
+  for (; x + 32 <= width; x += 32)
+  {
+    const __m256i left = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(paddedMines + x));
+    const __m256i middle = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(paddedMines + x + 1));
+    const __m256i right = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(paddedMines + x + 2));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(sums + x), _mm256_add_epi8(_mm256_add_epi8(left, middle), right));
+  }
+  sumRowScalar(paddedMines, sums, x, width);
+}
+
+__attribute__((target("avx2"))) void
+combineRowsAVX2(uint8_t *cells, const uint8_t *above, const uint8_t *row, const uint8_t *below, const int width)
+{
+  const __m256i one = _mm256_set1_epi8(1);
+  const __m256i stateMask = _mm256_set1_epi8(static_cast<char>(~Minesweeper::Cell::ADJACENT_MINES_MASK));
+  int x = 0;
+  for (; x + 32 <= width; x += 32)
+  {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(cells + x));
+    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(above + x));
+    const __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + x));
+    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(below + x));
+    const __m256i mine = _mm256_and_si256(_mm256_srli_epi16(v, MINE_SHIFT), one);
+    const __m256i count = _mm256_sub_epi8(_mm256_add_epi8(_mm256_add_epi8(a, r), b), mine);
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(cells + x), _mm256_or_si256(_mm256_and_si256(v, stateMask), count));
+  }
+  combineRowsScalar(cells, above, row, below, x, width);
+}
+
+const Kernels AVX2_KERNELS = {extractMinesAVX2, sumRowAVX2, combineRowsAVX2, "avx2"};
+
+#endif
+
+const Kernels &getKernels()
+{
+  static const Kernels &kernels = []() -> const Kernels &
+  {
+#ifdef MINE_COUNTER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+      return AVX2_KERNELS;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+      return SSE2_KERNELS;
+    }
+#endif
+    return SCALAR_KERNELS;
+  }();
+  return kernels;
+}
+} // namespace
+
+void MineCounter::countAdjacentMines(uint8_t *cells, const int width, const int height)
+{
+  const auto &kernels = getKernels();
+
+  // one zero column either side of the mine row, and one zero row of sums above and below the grid
+  paddedMines.assign(width + 2, 0);
+  rowSums.resize(static_cast<std::size_t>(height + 2) * width);
+  std::fill_n(rowSums.begin(), width, 0);
+  std::fill_n(rowSums.end() - width, width, 0);
+
+  for (int y = 0; y < height; ++y)
+  {
+    kernels.extractMines(cells + static_cast<std::size_t>(y) * width, paddedMines.data() + 1, width);
+    kernels.sumRow(paddedMines.data(), rowSums.data() + static_cast<std::size_t>(y + 1) * width, width);
+  }
+
+  for (int y = 0; y < height; ++y)
+  {
+    const uint8_t *sums = rowSums.data() + static_cast<std::size_t>(y + 1) * width;
+    kernels.combineRows(cells + static_cast<std::size_t>(y) * width, sums - width, sums, sums + width, width);
+  }
+}
+
+const char *MineCounter::getKernelName() { return getKernels().name; }
@@ -1,210 +1,364 @@
 #include <Minesweeper.hpp>
-#include <SDL2/SDL.h>
-#include <config.hpp>
-#include <iostream>
+#include <NoGuessGenerator.hpp>
+#include <algorithm>
+#include <cstdlib>
 #include <random>
 #include <set>
 #include <utility>
-#include <utils.hpp>
 #include <vector>
 
-Minesweeper::Minesweeper() { minefield = initMinefield(); }
+Minesweeper::Minesweeper(const int w, const int h, const int m) : gridWidth(w), gridHeight(h), targetNumMines(m)
+{
+  // the only non-deterministic input; every board after this is derived from seedSource
+  std::random_device rd;
+  seedSource.reseed((static_cast<uint64_t>(rd()) << 32) | rd());
+  seed = seedSource.next();
+
+  clearMinefield();
+}
 
 void Minesweeper::handleLeftClick(const int row, const int col)
 {
-  const auto index = rowColToIndex(row, col);
+  revealedCells.clear();
 
   if (isFirstClick)
   {
     isFirstClick = false;
-    while (true)
+    if (noGuessGenerator)
     {
-      minefield = initMinefield();
-      auto &firstCell = minefield[index];
-      if (firstCell.nAdjacentMines == 0 && !firstCell.isMine)
-      {
-        break;
-      }
+      seed = noGuessGenerator->findSeed(gridWidth, gridHeight, numMines, row, col, seed);
     }
+    initMinefield(row, col);
+  }
+
+  revealCell(row, col);
+  markRevealedCellsDirty();
+};
+
+void Minesweeper::handleRightClick(const int row, const int col)
+{
+  revealedCells.clear();
+
+  auto &cell = minefield[rowColToIndex(row, col)];
+
+  if (!cell.getIsHidden())
+  {
+    return;
+  }
+
+  if (!cell.getIsFlagged() && numFlags == numMines)
+  {
+    return;
   }
 
+  cell.setIsFlagged(!cell.getIsFlagged());
+  markCellDirty(rowColToIndex(row, col));
+
+  const int delta = cell.getIsFlagged() ? 1 : -1;
+  numFlags += delta;
+  if (cell.getIsMine())
+  {
+    numFlaggedMines += delta;
+  }
+};
+
+void Minesweeper::handleMiddleClick(const int row, const int col)
+{
+  const auto index = rowColToIndex(row, col);
+  revealedCells.clear();
+
+  if (minefield[index].getIsHidden())
+  {
+    return;
+  }
+
+  revealAdjacentCells(row, col);
+  markRevealedCellsDirty();
+};
+
+void Minesweeper::reset() { reset(seedSource.next()); }
+
+void Minesweeper::reset(const uint64_t newSeed)
+{
+  seed = newSeed;
+  clearMinefield();
+  revealedCells.clear();
+  isGameOver = false;
+  isGameWon = false;
+  isFirstClick = true;
+  secondsElapsed = 0;
+}
+
+void Minesweeper::startGame(const uint64_t newSeed, const int row, const int col)
+{
+  // replays the given board as is, so this skips the no-guess search
+  reset(newSeed);
+  isFirstClick = false;
+  initMinefield(row, col);
+  revealCell(row, col);
+  markRevealedCellsDirty();
+}
+
+void Minesweeper::clearDirtyCells()
+{
+  dirtyCells.clear();
+  isFullRedrawNeeded = false;
+}
+
+void Minesweeper::markAllCellsDirty()
+{
+  dirtyCells.clear();
+  isFullRedrawNeeded = true;
+}
+
+void Minesweeper::revealCell(const int row, const int col)
+{
+  const auto index = rowColToIndex(row, col);
+
   auto &cell = minefield[index];
-  if (cell.isFlagged || !cell.isHidden)
+  if (cell.getIsFlagged() || !cell.getIsHidden())
   {
     return;
   }
-  cell.isHidden = false;
+  cell.setIsHidden(false);
+  revealedCells.push_back(index);
 
-  if (cell.isMine)
+  if (cell.getIsMine())
   {
     isGameOver = true;
-    cell.isClicked = true;
+    cell.setIsClicked(true);
     ++numFlags;
-    for (auto &ele : minefield)
+    for (int i = 0; i < static_cast<int>(minefield.size()); ++i)
     {
-      if (ele.isMine)
+      if (minefield[i].getIsMine() && minefield[i].getIsHidden())
       {
-        ele.isHidden = false;
+        minefield[i].setIsHidden(false);
+        revealedCells.push_back(i);
+      }
+      else if (minefield[i].getIsFlagged() && minefield[i].getIsHidden())
+      {
+        // wrong flags turn into crossed-out mines once the game is over
+        markCellDirty(i);
       }
     }
     return;
   }
 
-  if (cell.nAdjacentMines == 0)
+  --numHiddenSafeCells;
+
+  if (cell.getNumAdjacentMines() == 0)
   {
     floodFillEmptyCells(row, col);
   }
-};
+}
 
-void Minesweeper::handleRightClick(const int row, const int col)
+void Minesweeper::clearMinefield()
 {
-  auto &cell = minefield[rowColToIndex(row, col)];
+  // mines are only placed once the first click is known, see initMinefield
+  minefield.assign(gridWidth * gridHeight, Cell{});
+  numMines = std::clamp(targetNumMines, 0, std::max(static_cast<int>(minefield.size()) - 9, 0));
+  numFlags = 0;
+  numFlaggedMines = 0;
+  numHiddenSafeCells = static_cast<int>(minefield.size());
+  markAllCellsDirty();
+}
 
-  if (!cell.isHidden)
+void Minesweeper::markCellDirty(const int index)
+{
+  if (isFullRedrawNeeded)
   {
     return;
   }
 
-  if (!cell.isFlagged && numFlags == numMines)
+  // nobody is consuming the list (headless play), or a redraw of everything is cheaper anyway
+  if (dirtyCells.size() >= minefield.size())
   {
+    markAllCellsDirty();
     return;
   }
 
-  cell.isFlagged = !cell.isFlagged;
-
-  numFlags += cell.isFlagged ? 1 : -1;
-};
+  dirtyCells.push_back(index);
+}
 
-void Minesweeper::handleMiddleClick(const int row, const int col)
+void Minesweeper::markRevealedCellsDirty()
 {
-  const auto index = rowColToIndex(row, col);
-
-  if (minefield[index].isHidden)
+  if (isFullRedrawNeeded)
   {
     return;
   }
 
-  revealAdjacentCells(row, col);
-};
+  if (dirtyCells.size() + revealedCells.size() > minefield.size())
+  {
+    markAllCellsDirty();
+    return;
+  }
 
-void Minesweeper::reset()
-{
-  minefield = initMinefield();
-  isGameOver = false;
-  isFirstClick = true;
-  secondsElapsed = 0;
+  dirtyCells.insert(dirtyCells.end(), revealedCells.begin(), revealedCells.end());
 }
 
-std::vector<Minesweeper::Cell> Minesweeper::initMinefield()
+void Minesweeper::initMinefield(const int safeRow, const int safeCol)
 {
-  std::random_device rd;
-  std::mt19937 rg(rd());
-  std::bernoulli_distribution dist(config::MINE_FREQUENCY);
+  Random random(seed);
 
-  std::vector<Cell> data(config::getSettings().getGridHeight() * config::getSettings().getGridWidth());
-  numMines = 0;
+  // flags placed before the first click are wiped along with the board
+  for (int i = 0; i < static_cast<int>(minefield.size()); ++i)
+  {
+    if (minefield[i].getIsFlagged())
+    {
+      markCellDirty(i);
+    }
+  }
+  minefield.assign(gridWidth * gridHeight, Cell{});
   numFlags = 0;
   secondsElapsed = 0;
 
-  for (int i = 0; i < config::getSettings().getGridHeight() * config::getSettings().getGridWidth(); ++i)
+  // the first click and its neighbours are kept clear so the first reveal always opens a region
+  std::array<int, 9> safeCells;
+  int numSafeCells = 0;
+  for (int dRow = -1; dRow <= 1; ++dRow)
   {
-    bool isMine = dist(rg); // random
-    bool isHidden = true;
-    bool isFlagged = false;
+    for (int dCol = -1; dCol <= 1; ++dCol)
+    {
+      if (isValidCell(safeRow + dRow, safeCol + dCol))
+      {
+        safeCells[numSafeCells++] = rowColToIndex(safeRow + dRow, safeCol + dCol);
+      }
+    }
+  }
 
-    if (isMine)
+  // maps the n-th mine candidate to its cell index by skipping over the (ascending) safe cells
+  const auto candidateToIndex = [&](int candidate)
+  {
+    for (int i = 0; i < numSafeCells && safeCells[i] <= candidate; ++i)
     {
-      const int row = i / config::getSettings().getGridWidth();
-      const int col = i % config::getSettings().getGridWidth();
+      ++candidate;
+    }
+    return candidate;
+  };
 
-      ++numMines;
+  const int numCandidates = static_cast<int>(minefield.size()) - numSafeCells;
+  numMines = std::min(numMines, numCandidates);
 
-      // right
-      if (col != config::getSettings().getGridWidth() - 1)
-      {
-        ++data[i + 1].nAdjacentMines;
-      }
+  // bumping the neighbours of each mine is cheapest on sparse boards, past that the vectorized box sum wins
+  const bool isSparse = numMines < static_cast<int>(minefield.size()) / SPARSE_BOARD_CELLS_PER_MINE;
 
-      // left
-      if (col != 0)
-      {
-        ++data[i - 1].nAdjacentMines;
-      }
+  // Floyd's algorithm: numMines distinct candidates using exactly one draw per mine
+  for (int j = numCandidates - numMines; j < numCandidates; ++j)
+  {
+    int index = candidateToIndex(random.nextBelow(j + 1));
+    if (minefield[index].getIsMine())
+    {
+      index = candidateToIndex(j);
+    }
 
-      // top
-      if (row != 0)
-      {
-        ++data[i - config::getSettings().getGridWidth()].nAdjacentMines;
-      }
+    if (isSparse)
+    {
+      placeMine(index);
+    }
+    else
+    {
+      minefield[index].setIsMine(true);
+    }
+  }
 
-      // bot
-      if (row != config::getSettings().getGridHeight() - 1)
-      {
-        ++data[i + config::getSettings().getGridWidth()].nAdjacentMines;
-      }
+  if (!isSparse)
+  {
+    mineCounter.countAdjacentMines(reinterpret_cast<uint8_t *>(minefield.data()), gridWidth, gridHeight);
+  }
 
-      // top-left
-      if (row != 0 && col != 0)
-      {
-        ++data[i - config::getSettings().getGridWidth() - 1].nAdjacentMines;
-      }
+  numHiddenSafeCells = static_cast<int>(minefield.size()) - numMines;
+  numFlaggedMines = 0;
+}
 
-      // top-right
-      if (row != 0 && col != config::getSettings().getGridWidth() - 1)
-      {
-        ++data[i - config::getSettings().getGridWidth() + 1].nAdjacentMines;
-      }
+void Minesweeper::placeMine(const int index)
+{
+  const int row = index / gridWidth;
+  const int col = index % gridWidth;
 
-      // bot-left
-      if (row != config::getSettings().getGridHeight() - 1 && col != 0)
-      {
-        ++data[i + config::getSettings().getGridWidth() - 1].nAdjacentMines;
-      }
+  minefield[index].setIsMine(true);
 
-      // bot-right
-      if (row != config::getSettings().getGridHeight() - 1 && col != config::getSettings().getGridWidth() - 1)
-      {
-        ++data[i + config::getSettings().getGridWidth() + 1].nAdjacentMines;
-      }
-    }
+  // right
+  if (col != gridWidth - 1)
+  {
+    minefield[index + 1].incrementNumAdjacentMines();
+  }
 
-    data[i] = {isMine, isHidden, isFlagged, false, data[i].nAdjacentMines};
+  // left
+  if (col != 0)
+  {
+    minefield[index - 1].incrementNumAdjacentMines();
+  }
+
+  // top
+  if (row != 0)
+  {
+    minefield[index - gridWidth].incrementNumAdjacentMines();
+  }
+
+  // bot
+  if (row != gridHeight - 1)
+  {
+    minefield[index + gridWidth].incrementNumAdjacentMines();
+  }
+
+  // top-left
+  if (row != 0 && col != 0)
+  {
+    minefield[index - gridWidth - 1].incrementNumAdjacentMines();
+  }
+
+  // top-right
+  if (row != 0 && col != gridWidth - 1)
+  {
+    minefield[index - gridWidth + 1].incrementNumAdjacentMines();
+  }
+
+  // bot-left
+  if (row != gridHeight - 1 && col != 0)
+  {
+    minefield[index + gridWidth - 1].incrementNumAdjacentMines();
+  }
+
+  // bot-right
+  if (row != gridHeight - 1 && col != gridWidth - 1)
+  {
+    minefield[index + gridWidth + 1].incrementNumAdjacentMines();
   }
-  return data;
 }
 
-int Minesweeper::rowColToIndex(const int row, const int col) const
+int Minesweeper::rowColToIndex(const int row, const int col) const { return row * gridWidth + col; }
+
+bool Minesweeper::isValidCell(const int row, const int col) const
 {
-  return row * config::getSettings().getGridWidth() + col;
+  return row >= 0 && col >= 0 && row < gridHeight && col < gridWidth;
 }
 
 void Minesweeper::revealAdjacentCells(const int row, const int col)
 {
-  unsigned int numAdjacentFlags = 0;
+  int numAdjacentFlags = 0;
   std::set<std::pair<int, int>> hidden;
 
   for (const auto &[dRow, dCol] : ADJACENCY_OFFSETS)
   {
     const int currentRow = row + dRow;
     const int currentCol = col + dCol;
-    if (currentRow < 0 || currentCol < 0 || currentRow >= config::getSettings().getGridHeight() ||
-        currentCol >= config::getSettings().getGridWidth())
+    if (!isValidCell(currentRow, currentCol))
     {
       continue;
     }
 
     const auto currentCell = minefield[rowColToIndex(currentRow, currentCol)];
-    if (currentCell.isFlagged)
+    if (currentCell.getIsFlagged())
     {
       ++numAdjacentFlags;
     }
-    else if (currentCell.isHidden)
+    else if (currentCell.getIsHidden())
     {
       hidden.insert({currentRow, currentCol});
     }
   }
 
-  const bool allAdjacentMinesAreFlagged = numAdjacentFlags == minefield[rowColToIndex(row, col)].nAdjacentMines;
+  const bool allAdjacentMinesAreFlagged = numAdjacentFlags == minefield[rowColToIndex(row, col)].getNumAdjacentMines();
   if (!allAdjacentMinesAreFlagged)
   {
     return;
@@ -212,62 +366,70 @@ void Minesweeper::revealAdjacentCells(const int row, const int col)
 
   for (const auto &[currentRow, currentCol] : hidden)
   {
-    handleLeftClick(currentRow, currentCol);
+    revealCell(currentRow, currentCol);
   }
 }
 
-void Minesweeper::floodFillEmptyCells(int row, int col)
+const std::vector<int> &Minesweeper::floodFillEmptyCells(const int row, const int col)
 {
-  std::set<std::pair<int, int>> visited;
-  floodFillEmptyCellsRecursive(row, col, visited);
-}
+  // revealedCells doubles as the BFS queue: every cell is appended exactly once, when it is revealed, so the hidden
+  // bit is the visited set and the only storage is the delta handed back to the caller
+  std::size_t head = revealedCells.size();
+  int index = rowColToIndex(row, col);
 
-void Minesweeper::floodFillEmptyCellsRecursive(int row, int col, std::set<std::pair<int, int>> &visited)
-{
-  visited.insert({row, col});
-
-  for (const auto &[dRow, dCol] : ADJACENCY_OFFSETS)
+  while (true)
   {
-    const int newRow = row + dRow;
-    const int newCol = col + dCol;
-    if (!utils::isValidCell(newRow, newCol))
-    {
-      continue;
-    }
+    const int currentRow = index / gridWidth;
+    const int currentCol = index % gridWidth;
 
-    const std::pair<int, int> p{newRow, newCol};
-    if (visited.find(p) != visited.end())
+    for (const auto &[dRow, dCol] : ADJACENCY_OFFSETS)
     {
-      continue;
+      const int newRow = currentRow + dRow;
+      const int newCol = currentCol + dCol;
+      if (!isValidCell(newRow, newCol))
+      {
+        continue;
+      }
+
+      const int newIndex = rowColToIndex(newRow, newCol);
+      auto &cell = minefield[newIndex];
+      if (!cell.getIsHidden() || cell.getIsMine())
+      {
+        continue;
+      }
+
+      if (cell.getIsFlagged())
+      {
+        cell.setIsFlagged(false);
+        --numFlags;
+      }
+      cell.setIsHidden(false);
+      revealedCells.push_back(newIndex);
+      --numHiddenSafeCells;
     }
-    else
+
+    while (head < revealedCells.size() && minefield[revealedCells[head]].getNumAdjacentMines() != 0)
     {
-      visited.insert(p);
+      ++head;
     }
 
-    const int index = p.first * config::getSettings().getGridWidth() + p.second;
-    auto &cell = minefield[index];
-    if (!cell.isMine)
+    if (head == revealedCells.size())
     {
-      cell.isHidden = false;
-      if (cell.nAdjacentMines == 0)
-      {
-        floodFillEmptyCellsRecursive(newRow, newCol, visited);
-      }
+      break;
     }
+
+    index = revealedCells[head++];
   }
+
+  return revealedCells;
 }
 
 void Minesweeper::checkForGameWon()
 {
-  for (auto &cell : minefield)
+  // won once every safe cell is revealed and every mine is flagged
+  if (isGameOver || numHiddenSafeCells != 0 || numFlaggedMines != numMines)
   {
-    const auto isFlaggedMine = cell.isMine && cell.isFlagged;
-    const auto isRevealed = !cell.isHidden;
-    if (!(isFlaggedMine || isRevealed))
-    {
-      return;
-    }
+    return;
   }
 
   isGameOver = true;
@@ -0,0 +1,126 @@
+#include <Minesweeper.hpp>
+#include <NoGuessGenerator.hpp>
+#include <Solver.hpp>
+#include <ThreadPool.hpp>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <mutex>
+
+NoGuessGenerator::NoGuessGenerator(ThreadPool &p, const std::chrono::milliseconds t, const int m)
+    : pool(p), timeBudget(t), maxAttempts(m)
+{
+}
+
+uint64_t NoGuessGenerator::findSeed(
+    const int gridWidth,
+    const int gridHeight,
+    const int numMines,
+    const int row,
+    const int col,
+    const uint64_t firstSeed)
+{
+  const auto deadline = std::chrono::steady_clock::now() + timeBudget;
+
+  std::atomic<int> nextAttempt{0};
+  std::atomic<int> numFinishedAttempts{0};
+  // cancellation token: attempts past the best passing one can't win, so workers stop taking them
+  std::atomic<int> bestAttempt{INT_MAX};
+  // the lowest attempt the deadline cut short; a passing attempt above it might not be the lowest passing one
+  std::atomic<int> firstUnfinishedAttempt{INT_MAX};
+
+  // the fallback, should nothing pass; only used once every attempt has finished, so it doesn't depend on timing
+  std::mutex fallbackMutex;
+  int fallbackAttempt = 0;
+  int fallbackNumHiddenSafeCells = INT_MAX;
+
+  const auto lower = [](std::atomic<int> &value, const int newVal)
+  {
+    int current = value;
+    while (newVal < current && !value.compare_exchange_weak(current, newVal))
+    {
+    }
+  };
+
+  const auto search = [&]
+  {
+    Minesweeper candidate(gridWidth, gridHeight, numMines);
+    Solver solver(candidate);
+
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+      const int attempt = nextAttempt++;
+      if (attempt >= maxAttempts || attempt > bestAttempt)
+      {
+        return;
+      }
+
+      candidate.startGame(toCandidateSeed(firstSeed, attempt), row, col);
+      solver.reset();
+      solver.update(candidate.getRevealedCells());
+      while (!solver.getSafeCells().empty() && attempt < bestAttempt && std::chrono::steady_clock::now() < deadline)
+      {
+        const int index = solver.getSafeCells().back();
+        candidate.handleLeftClick(index / gridWidth, index % gridWidth);
+        solver.update(candidate.getRevealedCells());
+      }
+
+      if (!solver.getSafeCells().empty())
+      {
+        // cancelled past the best attempt, which doesn't matter, or out of time, which does
+        if (attempt < bestAttempt)
+        {
+          lower(firstUnfinishedAttempt, attempt);
+        }
+        return;
+      }
+      ++numFinishedAttempts;
+
+      if (candidate.getNumHiddenSafeCells() == 0)
+      {
+        lower(bestAttempt, attempt);
+        return;
+      }
+
+      std::lock_guard<std::mutex> lock(fallbackMutex);
+      if (candidate.getNumHiddenSafeCells() < fallbackNumHiddenSafeCells ||
+          (candidate.getNumHiddenSafeCells() == fallbackNumHiddenSafeCells && attempt < fallbackAttempt))
+      {
+        fallbackAttempt = attempt;
+        fallbackNumHiddenSafeCells = candidate.getNumHiddenSafeCells();
+      }
+    }
+  };
+
+  {
+    // the pool may be shared, so only this call's searches are waited for
+    ThreadPool::TaskGroup group(pool);
+    for (int i = 0; i < pool.getNumThreads(); ++i)
+    {
+      group.submit(search);
+    }
+    group.wait();
+  }
+
+  numAttempts = numFinishedAttempts;
+
+  // attempts are handed out in order, so every attempt below one that was handed out was too; the result is the
+  // lowest passing attempt only if all of those finished
+  isNoGuess = bestAttempt < firstUnfinishedAttempt && bestAttempt != INT_MAX;
+  if (isNoGuess)
+  {
+    return toCandidateSeed(firstSeed, bestAttempt);
+  }
+
+  // the fallback is only the same on every machine when all maxAttempts finished; otherwise it's firstSeed itself
+  const bool isExhausted = numFinishedAttempts == maxAttempts;
+  return toCandidateSeed(firstSeed, isExhausted ? fallbackAttempt : 0);
+}
+
+// private
+
+uint64_t NoGuessGenerator::toCandidateSeed(const uint64_t firstSeed, const int attempt)
+{
+  return firstSeed + static_cast<uint64_t>(attempt) * 0x9e3779b97f4a7c15;
+}
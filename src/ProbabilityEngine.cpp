@@ -0,0 +1,471 @@
+#include <Minesweeper.hpp>
+#include <ProbabilityEngine.hpp>
+#include <ThreadPool.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace
+{
+// a mine count distribution over [lo, lo + values.size())
+struct Window
+{
+  int lo = 0;
+  std::vector<double> values;
+
+  int hi() const { return lo + static_cast<int>(values.size()) - 1; }
+  double at(const int t) const { return t < lo || t > hi() ? 0.0 : values[t - lo]; }
+};
+
+// log of a weight that can't happen
+constexpr double NEVER = -std::numeric_limits<double>::infinity();
+
+// entries this far below a distribution's peak can't move a double-precision probability
+constexpr double NEGLIGIBLE_SHARE = 1e-40;
+
+double logBinomial(const int n, const int k)
+{
+  return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0);
+}
+
+void trim(Window &window)
+{
+  const double peak = *std::max_element(window.values.begin(), window.values.end());
+  if (peak <= 0)
+  {
+    return;
+  }
+
+  const auto isSignificant = [&](const double value) { return value > peak * NEGLIGIBLE_SHARE; };
+
+  const auto first = std::find_if(window.values.begin(), window.values.end(), isSignificant);
+  const auto last = std::find_if(window.values.rbegin(), window.values.rend(), isSignificant).base();
+  window.lo += static_cast<int>(first - window.values.begin());
+  window.values = std::vector<double>(first, last);
+}
+} // namespace
+
+ProbabilityEngine::ProbabilityEngine(const Minesweeper &g, ThreadPool &p) : game(g), pool(p) {}
+
+bool ProbabilityEngine::compute(const std::chrono::milliseconds timeBudget)
+{
+  const auto deadline = std::chrono::steady_clock::now() + timeBudget;
+  const auto &minefield = game.getMinefield();
+
+  // mines already showing (only after a loss) are known and out of the count
+  int numMines = game.getNumMines();
+  for (const auto &cell : minefield)
+  {
+    numMines -= !cell.getIsHidden() && cell.getIsMine();
+  }
+
+  findComponents();
+
+  // biggest first, so one large component doesn't start last and hold everything up
+  std::sort(
+      components.begin(),
+      components.end(),
+      [](const Component &a, const Component &b) { return a.cells.size() > b.cells.size(); });
+  // the pool may be busy with other callers' work, so only this call's components are waited for
+  ThreadPool::TaskGroup group(pool);
+  for (auto &component : components)
+  {
+    group.submit([this, &component, numMines, deadline] { enumerate(component, numMines, deadline); });
+  }
+  group.wait();
+
+  numTimedOutComponents = 0;
+  int numOutsideCells = 0;
+  for (const auto &cell : minefield)
+  {
+    numOutsideCells += cell.getIsHidden();
+  }
+  for (const auto &component : components)
+  {
+    numTimedOutComponents += component.isTimedOut;
+    numOutsideCells -= component.isTimedOut ? 0 : static_cast<int>(component.cells.size());
+  }
+
+  combine(numMines, numOutsideCells);
+  return numTimedOutComponents == 0;
+}
+
+// private
+
+bool ProbabilityEngine::isValidCell(const int row, const int col) const
+{
+  return row >= 0 && col >= 0 && row < game.getGridHeight() && col < game.getGridWidth();
+}
+
+template <typename Callback> void ProbabilityEngine::forEachNeighbour(const int index, Callback callback) const
+{
+  const int row = index / game.getGridWidth();
+  const int col = index % game.getGridWidth();
+
+  for (const auto &[dRow, dCol] : ADJACENCY_OFFSETS)
+  {
+    if (isValidCell(row + dRow, col + dCol))
+    {
+      callback(index + dRow * game.getGridWidth() + dCol);
+    }
+  }
+}
+
+void ProbabilityEngine::findComponents()
+{
+  const auto &minefield = game.getMinefield();
+  const auto isConstraint = [&](const int index)
+  { return !minefield[index].getIsHidden() && !minefield[index].getIsMine(); };
+
+  components.clear();
+
+  // position of a frontier cell or number within its component; the two never overlap since one is hidden
+  std::vector<int> slots(minefield.size(), -1);
+
+  for (int index = 0; index < static_cast<int>(minefield.size()); ++index)
+  {
+    if (slots[index] >= 0 || !isConstraint(index))
+    {
+      continue;
+    }
+
+    bool hasHiddenNeighbour = false;
+    forEachNeighbour(index, [&](const int neighbour) { hasHiddenNeighbour |= minefield[neighbour].getIsHidden(); });
+    if (!hasHiddenNeighbour)
+    {
+      continue;
+    }
+
+    // breadth first from number to cell to number, which also gives the backtracking a good assignment order:
+    // consecutive cells share numbers, so a bad partial layout is caught a few cells after it is made
+    Component component;
+    const auto addNumber = [&](const int number)
+    {
+      if (isConstraint(number) && slots[number] < 0)
+      {
+        slots[number] = static_cast<int>(component.constraints.size());
+        component.constraints.push_back(number);
+      }
+    };
+    const auto addCell = [&](const int cell)
+    {
+      if (minefield[cell].getIsHidden() && slots[cell] < 0)
+      {
+        slots[cell] = static_cast<int>(component.cells.size());
+        component.cells.push_back(cell);
+        forEachNeighbour(cell, addNumber);
+      }
+    };
+
+    addNumber(index);
+    for (std::size_t head = 0; head < component.constraints.size(); ++head)
+    {
+      forEachNeighbour(component.constraints[head], addCell);
+    }
+
+    for (const int number : component.constraints)
+    {
+      int numMinesNeeded = minefield[number].getNumAdjacentMines();
+      int numCells = 0;
+      const auto countNeighbour = [&](const int neighbour)
+      {
+        numMinesNeeded -= !minefield[neighbour].getIsHidden() && minefield[neighbour].getIsMine();
+        numCells += minefield[neighbour].getIsHidden();
+      };
+      forEachNeighbour(number, countNeighbour);
+      component.constraintMines.push_back(numMinesNeeded);
+      component.constraintCells.push_back(numCells);
+    }
+
+    const auto addCellConstraint = [&](const int neighbour)
+    {
+      if (isConstraint(neighbour))
+      {
+        component.cellConstraints.push_back(slots[neighbour]);
+      }
+    };
+    component.cellConstraintOffsets.push_back(0);
+    for (const int cell : component.cells)
+    {
+      forEachNeighbour(cell, addCellConstraint);
+      component.cellConstraintOffsets.push_back(static_cast<int>(component.cellConstraints.size()));
+    }
+
+    components.push_back(std::move(component));
+  }
+}
+
+void ProbabilityEngine::enumerate(
+    Component &component,
+    const int maxMines,
+    const std::chrono::steady_clock::time_point deadline) const
+{
+  const int numCells = static_cast<int>(component.cells.size());
+  auto minesNeeded = component.constraintMines;
+  auto cellsOpen = component.constraintCells;
+
+  // assigns (or with sign -1 takes back) a value for one cell and reports whether every number it touches can still
+  // be satisfied by the cells left open
+  int numMines = 0;
+  std::vector<uint64_t> mineBits((numCells + 63) / 64);
+  const auto apply = [&](const int cell, const int value, const int sign)
+  {
+    numMines += sign * value;
+    mineBits[cell / 64] ^= static_cast<uint64_t>(value) << (cell % 64);
+
+    bool isFeasible = numMines <= maxMines;
+    for (int i = component.cellConstraintOffsets[cell]; i < component.cellConstraintOffsets[cell + 1]; ++i)
+    {
+      const int constraint = component.cellConstraints[i];
+      cellsOpen[constraint] -= sign;
+      minesNeeded[constraint] -= sign * value;
+      isFeasible &= minesNeeded[constraint] >= 0 && minesNeeded[constraint] <= cellsOpen[constraint];
+    }
+    return isFeasible;
+  };
+
+  component.layouts.assign(numCells + 1, 0.0);
+  component.cellMines.assign(numCells + 1, {});
+
+  // iterative so a long frontier can't overflow a worker's stack; values[depth] is -1 untried, then 0, then 1
+  std::vector<int8_t> values(numCells, -1);
+  uint32_t numSteps = 0;
+  int depth = 0;
+  while (depth >= 0)
+  {
+    if (depth == numCells)
+    {
+      component.layouts[numMines] += 1.0;
+      auto &cellMines = component.cellMines[numMines];
+      cellMines.resize(numCells);
+      for (std::size_t word = 0; word < mineBits.size(); ++word)
+      {
+        for (uint64_t bits = mineBits[word]; bits != 0; bits &= bits - 1)
+        {
+          cellMines[word * 64 + __builtin_ctzll(bits)] += 1.0;
+        }
+      }
+      --depth;
+      continue;
+    }
+
+    if (++numSteps % DEADLINE_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() > deadline)
+    {
+      component.isTimedOut = true;
+      return;
+    }
+
+    auto &value = values[depth];
+    if (value >= 0)
+    {
+      apply(depth, value, -1);
+    }
+    if (value == 1)
+    {
+      value = -1;
+      --depth;
+      continue;
+    }
+
+    ++value;
+    if (apply(depth, value, 1))
+    {
+      ++depth;
+    }
+  }
+
+  double numLayouts = 0;
+  for (const double layouts : component.layouts)
+  {
+    numLayouts += layouts;
+  }
+  if (numLayouts == 0)
+  {
+    return;
+  }
+
+  for (int k = 0; k <= numCells; ++k)
+  {
+    component.layouts[k] /= numLayouts;
+    for (auto &cellMines : component.cellMines[k])
+    {
+      cellMines /= numLayouts;
+    }
+  }
+}
+
+void ProbabilityEngine::combine(const int numMines, const int numOutsideCells)
+{
+  const auto &minefield = game.getMinefield();
+
+  std::vector<const Component *> exact;
+  int numFrontierCells = 0;
+  for (const auto &component : components)
+  {
+    if (!component.isTimedOut)
+    {
+      exact.push_back(&component);
+      numFrontierCells += static_cast<int>(component.cells.size());
+    }
+  }
+
+  // A layout putting t mines on the frontier leaves C(outside, numMines - t) ways to place the rest. That weight
+  // changes by orders of magnitude per mine, so layouts are tilted by ratio^k, with ratio the weight's own step at the
+  // expected t, which leaves the tilted weight nearly flat and lets negligible tails be trimmed safely.
+  double logRatio = 0;
+  if (numOutsideCells > 0)
+  {
+    const double expected = static_cast<double>(numMines) * numFrontierCells / (numFrontierCells + numOutsideCells);
+    const double ratio = (numMines - expected) / (numOutsideCells - numMines + expected + 1);
+    logRatio = ratio > 0 && std::isfinite(ratio) ? std::log(ratio) : 0;
+  }
+  const auto logWeight = [&](const int t)
+  {
+    const int rest = numMines - t;
+    if (rest < 0 || rest > numOutsideCells)
+    {
+      return NEVER;
+    }
+    return logBinomial(numOutsideCells, rest) - t * logRatio;
+  };
+
+  // tilted, peak-normalised layouts per component; any constant factor per component cancels out in the end
+  std::vector<Window> tilted(exact.size());
+  for (std::size_t j = 0; j < exact.size(); ++j)
+  {
+    auto &window = tilted[j];
+    const auto &layouts = exact[j]->layouts;
+    std::vector<double> logs(layouts.size(), NEVER);
+    double peak = NEVER;
+    for (std::size_t k = 0; k < layouts.size(); ++k)
+    {
+      if (layouts[k] > 0)
+      {
+        logs[k] = std::log(layouts[k]) + k * logRatio;
+        peak = std::max(peak, logs[k]);
+      }
+    }
+
+    window.values.assign(layouts.size(), 0.0);
+    for (std::size_t k = 0; k < layouts.size() && std::isfinite(peak); ++k)
+    {
+      window.values[k] = std::exp(logs[k] - peak);
+    }
+    trim(window);
+  }
+
+  // prefixes[j] is the mine count distribution of components [0, j)
+  std::vector<Window> prefixes(exact.size() + 1);
+  prefixes[0].values = {1.0};
+  for (std::size_t j = 0; j < exact.size(); ++j)
+  {
+    const auto &prefix = prefixes[j];
+    auto &next = prefixes[j + 1];
+    next.lo = prefix.lo + tilted[j].lo;
+    next.values.assign(prefix.values.size() + tilted[j].values.size() - 1, 0.0);
+    for (std::size_t a = 0; a < prefix.values.size(); ++a)
+    {
+      for (std::size_t k = 0; k < tilted[j].values.size(); ++k)
+      {
+        next.values[a + k] += prefix.values[a] * tilted[j].values[k];
+      }
+    }
+    trim(next);
+  }
+
+  // suffix[t] is the weight of everything after component j given t frontier mines before it, built backwards
+  const auto &all = prefixes.back();
+  double logPeak = NEVER;
+  for (int t = all.lo; t <= all.hi(); ++t)
+  {
+    logPeak = std::max(logPeak, logWeight(t));
+  }
+  Window suffix;
+  suffix.lo = all.lo;
+  for (int t = all.lo; t <= all.hi(); ++t)
+  {
+    suffix.values.push_back(std::exp(logWeight(t) - logPeak));
+  }
+
+  double total = 0;
+  double outsideMines = 0;
+  for (int t = all.lo; t <= all.hi(); ++t)
+  {
+    total += all.at(t) * suffix.at(t);
+    outsideMines += all.at(t) * suffix.at(t) * (numMines - t);
+  }
+
+  mineProbabilities.assign(minefield.size(), 0.0);
+  if (total <= 0 || !std::isfinite(total))
+  {
+    // only a contradictory board gets here; fall back to the plain density
+    int numHidden = 0;
+    for (const auto &cell : minefield)
+    {
+      numHidden += cell.getIsHidden();
+    }
+    for (std::size_t i = 0; i < minefield.size(); ++i)
+    {
+      mineProbabilities[i] = minefield[i].getIsHidden() ? static_cast<double>(numMines) / numHidden : 0.0;
+    }
+    return;
+  }
+
+  const double outsideProbability = numOutsideCells > 0 ? outsideMines / total / numOutsideCells : 0.0;
+  for (std::size_t i = 0; i < minefield.size(); ++i)
+  {
+    mineProbabilities[i] = minefield[i].getIsHidden() ? outsideProbability : 0.0;
+  }
+  for (const auto *component : exact)
+  {
+    for (const int cell : component->cells)
+    {
+      mineProbabilities[cell] = 0.0;
+    }
+  }
+
+  for (int j = static_cast<int>(exact.size()) - 1; j >= 0; --j)
+  {
+    const auto &prefix = prefixes[j];
+    const auto &window = tilted[j];
+    const auto &component = *exact[j];
+
+    // weight of every layout of the other components, given k mines in this one
+    for (int k = window.lo; k <= window.hi(); ++k)
+    {
+      if (window.at(k) == 0)
+      {
+        continue;
+      }
+
+      double weight = 0;
+      for (int a = prefix.lo; a <= prefix.hi(); ++a)
+      {
+        weight += prefix.at(a) * suffix.at(a + k);
+      }
+
+      const double share = window.at(k) / component.layouts[k] * weight / total;
+      const auto &cellMines = component.cellMines[k];
+      for (std::size_t i = 0; i < cellMines.size(); ++i)
+      {
+        mineProbabilities[component.cells[i]] += cellMines[i] * share;
+      }
+    }
+
+    Window next;
+    next.lo = prefix.lo;
+    next.values.assign(prefix.values.size(), 0.0);
+    for (int t = prefix.lo; t <= prefix.hi(); ++t)
+    {
+      for (int k = window.lo; k <= window.hi(); ++k)
+      {
+        next.values[t - prefix.lo] += window.at(k) * suffix.at(t + k);
+      }
+    }
+    suffix = std::move(next);
+  }
+}
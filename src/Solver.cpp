@@ -0,0 +1,253 @@
+#include <Minesweeper.hpp>
+#include <Solver.hpp>
+#include <algorithm>
+#include <vector>
+
+Solver::Solver(const Minesweeper &g) : game(g) { reset(); }
+
+void Solver::reset()
+{
+  const auto numCells = game.getMinefield().size();
+
+  knowledge.assign(numCells, Knowledge::UNKNOWN);
+  safeCells.clear();
+  safeCellPositions.assign(numCells, -1);
+  mineCells.clear();
+  frontier.clear();
+  frontierPositions.assign(numCells, -1);
+  dirty.clear();
+  isDirty.assign(numCells, false);
+}
+
+void Solver::update(const std::vector<int> &revealedCells)
+{
+  const auto &minefield = game.getMinefield();
+
+  for (const int index : revealedCells)
+  {
+    // a revealed mine ends the game, there is nothing left to deduce from it
+    if (minefield[index].getIsMine())
+    {
+      continue;
+    }
+
+    knowledge[index] = Knowledge::SAFE;
+    removeSafeCell(index);
+    markDirty(index);
+    markDirtyNeighbours(index);
+  }
+
+  while (!dirty.empty())
+  {
+    const int index = dirty.back();
+    dirty.pop_back();
+    isDirty[index] = false;
+    processConstraint(index);
+  }
+}
+
+// private
+
+bool Solver::isValidCell(const int row, const int col) const
+{
+  return row >= 0 && col >= 0 && row < game.getGridHeight() && col < game.getGridWidth();
+}
+
+bool Solver::isConstraint(const int index) const
+{
+  const auto cell = game.getMinefield()[index];
+  return !cell.getIsHidden() && !cell.getIsMine();
+}
+
+Solver::Constraint Solver::getConstraint(const int index) const
+{
+  const auto &minefield = game.getMinefield();
+  const int row = index / game.getGridWidth();
+  const int col = index % game.getGridWidth();
+
+  Constraint constraint;
+  constraint.remainingMines = minefield[index].getNumAdjacentMines();
+
+  for (const auto &[dRow, dCol] : ADJACENCY_OFFSETS)
+  {
+    if (!isValidCell(row + dRow, col + dCol))
+    {
+      continue;
+    }
+
+    const int neighbour = index + dRow * game.getGridWidth() + dCol;
+    if (knowledge[neighbour] == Knowledge::MINE)
+    {
+      --constraint.remainingMines;
+    }
+    else if (knowledge[neighbour] == Knowledge::UNKNOWN && minefield[neighbour].getIsHidden())
+    {
+      constraint.unknowns[constraint.numUnknowns++] = neighbour;
+    }
+  }
+
+  return constraint;
+}
+
+void Solver::markDirtyNeighbours(const int index)
+{
+  const int row = index / game.getGridWidth();
+  const int col = index % game.getGridWidth();
+
+  for (const auto &[dRow, dCol] : ADJACENCY_OFFSETS)
+  {
+    if (isValidCell(row + dRow, col + dCol))
+    {
+      markDirty(index + dRow * game.getGridWidth() + dCol);
+    }
+  }
+}
+
+void Solver::markDirty(const int index)
+{
+  if (isDirty[index] || !isConstraint(index))
+  {
+    return;
+  }
+
+  isDirty[index] = true;
+  dirty.push_back(index);
+}
+
+void Solver::setKnowledge(const int index, const Knowledge newKnowledge)
+{
+  if (knowledge[index] != Knowledge::UNKNOWN)
+  {
+    return;
+  }
+
+  knowledge[index] = newKnowledge;
+  if (newKnowledge == Knowledge::SAFE)
+  {
+    safeCellPositions[index] = static_cast<int>(safeCells.size());
+    safeCells.push_back(index);
+  }
+  else
+  {
+    mineCells.push_back(index);
+  }
+
+  // every number around the cell just lost an unknown
+  markDirtyNeighbours(index);
+}
+
+void Solver::updateFrontier(const int index, const bool isOnFrontier)
+{
+  auto &position = frontierPositions[index];
+
+  if (isOnFrontier && position < 0)
+  {
+    position = static_cast<int>(frontier.size());
+    frontier.push_back(index);
+  }
+  else if (!isOnFrontier && position >= 0)
+  {
+    frontierPositions[frontier.back()] = position;
+    frontier[position] = frontier.back();
+    frontier.pop_back();
+    position = -1;
+  }
+}
+
+void Solver::removeSafeCell(const int index)
+{
+  auto &position = safeCellPositions[index];
+  if (position < 0)
+  {
+    return;
+  }
+
+  safeCellPositions[safeCells.back()] = position;
+  safeCells[position] = safeCells.back();
+  safeCells.pop_back();
+  position = -1;
+}
+
+void Solver::processConstraint(const int index)
+{
+  const auto constraint = getConstraint(index);
+
+  updateFrontier(index, constraint.numUnknowns > 0);
+  if (constraint.numUnknowns == 0)
+  {
+    return;
+  }
+
+  if (constraint.remainingMines == 0 || constraint.remainingMines == constraint.numUnknowns)
+  {
+    const auto newKnowledge = constraint.remainingMines == 0 ? Knowledge::SAFE : Knowledge::MINE;
+    for (int i = 0; i < constraint.numUnknowns; ++i)
+    {
+      setKnowledge(constraint.unknowns[i], newKnowledge);
+    }
+    return;
+  }
+
+  // any number sharing an unknown with this one is at most two cells away
+  const int row = index / game.getGridWidth();
+  const int col = index % game.getGridWidth();
+  for (int dRow = -2; dRow <= 2; ++dRow)
+  {
+    for (int dCol = -2; dCol <= 2; ++dCol)
+    {
+      const int other = index + dRow * game.getGridWidth() + dCol;
+      if ((dRow == 0 && dCol == 0) || !isValidCell(row + dRow, col + dCol) || !isConstraint(other))
+      {
+        continue;
+      }
+
+      const auto otherConstraint = getConstraint(other);
+      if (otherConstraint.numUnknowns == 0)
+      {
+        continue;
+      }
+
+      applyPairRule(constraint, otherConstraint);
+      applyPairRule(otherConstraint, constraint);
+    }
+  }
+}
+
+void Solver::applyPairRule(const Constraint &a, const Constraint &b)
+{
+  // if a needs more mines than b could supply from the shared cells, the difference has to come from a's own cells:
+  // when that difference equals the number of cells only a has, those are all mines and b's own cells are all safe
+  const auto contains = [](const Constraint &constraint, const int index)
+  {
+    return std::find(constraint.unknowns.begin(), constraint.unknowns.begin() + constraint.numUnknowns, index) !=
+           constraint.unknowns.begin() + constraint.numUnknowns;
+  };
+
+  int numShared = 0;
+  for (int i = 0; i < a.numUnknowns; ++i)
+  {
+    numShared += contains(b, a.unknowns[i]);
+  }
+
+  const int numOnlyA = a.numUnknowns - numShared;
+  if (numShared == 0 || a.remainingMines - b.remainingMines != numOnlyA)
+  {
+    return;
+  }
+
+  for (int i = 0; i < a.numUnknowns; ++i)
+  {
+    if (!contains(b, a.unknowns[i]))
+    {
+      setKnowledge(a.unknowns[i], Knowledge::MINE);
+    }
+  }
+
+  for (int i = 0; i < b.numUnknowns; ++i)
+  {
+    if (!contains(a, b.unknowns[i]))
+    {
+      setKnowledge(b.unknowns[i], Knowledge::SAFE);
+    }
+  }
+}
@@ -1,110 +1,303 @@
 #include <HeaderArtist.hpp>
+#include <MappedFile.hpp>
 #include <MinefieldArtist.hpp>
 #include <Sprites.hpp>
+#include <ThreadPool.hpp>
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <config.hpp>
+#include <cstddef>
 #include <cstdint>
-#include <memory>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <system_error>
 #include <vector>
 
-Sprites::Sprites()
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+// CMakeLists.txt hashes every source that goes into drawing a sprite, so editing any of them stops old caches matching
+#ifndef SPRITE_SOURCE_HASH
+#error "SPRITE_SOURCE_HASH must be defined by the build"
+#endif
+
+namespace
+{
+constexpr uint64_t SPRITE_VERSION = SPRITE_SOURCE_HASH;
+
+constexpr char CACHE_MAGIC[8] = {'M', 'S', 'S', 'P', 'R', 'I', 'T', 'E'};
+
+// one cache line, so the pixels after it stay cache line aligned in the mapping
+struct alignas(64) CacheHeader
+{
+  char magic[8];
+  uint64_t key;
+  uint64_t numPixels;
+};
+
+static_assert(sizeof(CacheHeader) == 64, "the cache header must be exactly one cache line");
+
+// FNV-1a over everything the baked pixels depend on
+uint64_t getCacheKey(const int cellPixelSize, const int buttonSize)
+{
+  uint64_t hash = 14695981039346656037ull;
+  for (const uint32_t value :
+       {static_cast<uint32_t>(SPRITE_VERSION),
+        static_cast<uint32_t>(SPRITE_VERSION >> 32),
+        static_cast<uint32_t>(Sprites::NUM_SPRITES),
+        static_cast<uint32_t>(cellPixelSize),
+        static_cast<uint32_t>(buttonSize)})
+  {
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+      hash = (hash ^ ((value >> shift) & 0xff)) * 1099511628211ull;
+    }
+  }
+  return hash;
+}
+
+template <int N, uint32_t COLOR>
+void drawNumericSprite(std::vector<uint32_t> &buff, const int width)
+{
+  MinefieldArtist::drawNumericSprite(buff, width, N, COLOR);
+}
+
+using DrawSprite = void (*)(std::vector<uint32_t> &, const int);
+
+// indexed by SpriteId
+constexpr std::array<DrawSprite, Sprites::NUM_SPRITES> SPRITE_DRAWERS = {
+    HeaderArtist::drawRaisedResetButtonSprite,
+    HeaderArtist::drawPressedResetButtonSprite,
+    HeaderArtist::drawWinnerResetButtonSprite,
+    HeaderArtist::drawLoserResetButtonSprite,
+    HeaderArtist::drawRaisedConfigButtonSprite,
+    HeaderArtist::drawPressedConfigButtonSprite,
+    MinefieldArtist::drawHiddenCellSprite,
+    MinefieldArtist::drawFlaggedCellSprite,
+    MinefieldArtist::drawMineCellSprite,
+    MinefieldArtist::drawClickedMineCellSprite,
+    MinefieldArtist::drawMineCellRedXSprite,
+    MinefieldArtist::drawEmptyCellSprite,
+    drawNumericSprite<1, config::Colors::BLUE>,
+    drawNumericSprite<2, config::Colors::GREEN>,
+    drawNumericSprite<3, config::Colors::RED>,
+    drawNumericSprite<4, config::Colors::DARK_BLUE>,
+    drawNumericSprite<5, config::Colors::DARK_RED>,
+    drawNumericSprite<6, config::Colors::TURQUOISE>,
+    drawNumericSprite<7, config::Colors::PURPLE>,
+    drawNumericSprite<8, config::Colors::DARK_GREY>,
+};
+} // namespace
+
+Sprites::Sprites(const std::filesystem::path &cacheDir, ThreadPool *pool) : bakeStart(Clock::now())
+{
+  computeLayout();
+
+  cachePath = getCachePath(cacheDir);
+  if (!cachePath.empty() && loadCache(cachePath))
+  {
+    bakeTime = Clock::now() - bakeStart;
+    isBaked = true;
+    return;
+  }
+
+  drawSprites(pool);
+}
+
+Sprites::~Sprites()
 {
-  allocateMemory();
-  drawSprites();
-  createIntToSpriteMap();
+  // the drawing tasks write into this; the last one may still hold bakeMutex after announcing the end of the baking
+  waitUntilBaked();
+  std::lock_guard<std::mutex> lock(bakeMutex);
 }
 
+void Sprites::startBaking(ThreadPool &pool) { getOrCreate(&pool); }
+
 Sprites &Sprites::getInstance()
 {
-  static Sprites instance;
+  auto &instance = getOrCreate(nullptr);
+  instance.waitUntilBaked();
   return instance;
 }
 
-const Sprites::SpriteData *Sprites::get() { return data.get(); };
+Sprites &Sprites::getOrCreate(ThreadPool *pool)
+{
+  // only the first call's pool is used
+  static Sprites instance(config::getCacheDir(), pool);
+  return instance;
+}
 
-void Sprites::copy(
-    const std::vector<uint32_t> &source,
-    std::vector<uint32_t> &target,
-    const int width,
-    const int x,
-    const int y)
+void Sprites::computeLayout()
 {
-  // assumes square buffers
-  for (int row = 0; row < width; ++row)
+  const std::size_t pixelsPerCacheLine = CACHE_LINE_SIZE / sizeof(uint32_t);
+
+  numPixels = 0;
+  for (int i = 0; i < NUM_SPRITES; ++i)
   {
-    const auto first = source.begin() + row * width;
-    const auto result = target.begin() + (row + y) * config::getSettings().getGameWindowWidth() + x;
-    std::copy_n(first, width, result);
+    sizes[i] = i < toIndex(FIRST_CELL_SPRITE) ? config::INFO_PANEL_BUTTONS_HEIGHT
+                                               : config::getSettings().getCellPixelSize();
+    offsets[i] = numPixels;
+
+    // rounded up so the next sprite starts on a fresh cache line
+    const std::size_t spritePixels = sizes[i] * sizes[i];
+    numPixels += (spritePixels + pixelsPerCacheLine - 1) / pixelsPerCacheLine * pixelsPerCacheLine;
   }
 };
 
-void Sprites::allocateMemory()
-{
-  int resetButtonSize = config::INFO_PANEL_BUTTONS_HEIGHT * config::INFO_PANEL_BUTTONS_HEIGHT;
-  int cellSpriteSize = config::getSettings().getCellPixelSize() * config::getSettings().getCellPixelSize();
-
-  data->raisedResetButton.resize(resetButtonSize);
-  data->pressedResetButton.resize(resetButtonSize);
-  data->winnerResetButton.resize(resetButtonSize);
-  data->loserResetButton.resize(resetButtonSize);
-  data->raisedConfigButton.resize(resetButtonSize);
-  data->pressedConfigButton.resize(resetButtonSize);
-  data->empty.resize(cellSpriteSize);
-  data->hidden.resize(cellSpriteSize);
-  data->flag.resize(cellSpriteSize);
-  data->mine.resize(cellSpriteSize);
-  data->clickedMine.resize(cellSpriteSize);
-  data->redXMine.resize(cellSpriteSize);
-  data->zero.resize(cellSpriteSize);
-  data->one.resize(cellSpriteSize);
-  data->two.resize(cellSpriteSize);
-  data->three.resize(cellSpriteSize);
-  data->four.resize(cellSpriteSize);
-  data->five.resize(cellSpriteSize);
-  data->six.resize(cellSpriteSize);
-  data->seven.resize(cellSpriteSize);
-  data->eight.resize(cellSpriteSize);
-};
+std::filesystem::path Sprites::getCachePath(const std::filesystem::path &cacheDir) const
+{
+  if (cacheDir.empty())
+  {
+    return {};
+  }
 
-void Sprites::drawSprites()
-{
-  HeaderArtist::drawRaisedResetButtonSprite(data->raisedResetButton, config::INFO_PANEL_BUTTONS_HEIGHT);
-  HeaderArtist::drawPressedResetButtonSprite(data->pressedResetButton, config::INFO_PANEL_BUTTONS_HEIGHT);
-  HeaderArtist::drawWinnerResetButtonSprite(data->winnerResetButton, config::INFO_PANEL_BUTTONS_HEIGHT);
-  HeaderArtist::drawLoserResetButtonSprite(data->loserResetButton, config::INFO_PANEL_BUTTONS_HEIGHT);
-  HeaderArtist::drawRaisedConfigButtonSprite(data->raisedConfigButton, config::INFO_PANEL_BUTTONS_HEIGHT);
-  HeaderArtist::drawPressedConfigButtonSprite(data->pressedConfigButton, config::INFO_PANEL_BUTTONS_HEIGHT);
-
-  MinefieldArtist::drawEmptyCellSprite(data->empty, config::getSettings().getCellPixelSize());
-  MinefieldArtist::drawHiddenCellSprite(data->hidden, config::getSettings().getCellPixelSize());
-  MinefieldArtist::drawFlaggedCellSprite(data->flag, config::getSettings().getCellPixelSize());
-  MinefieldArtist::drawMineCellSprite(data->mine, config::getSettings().getCellPixelSize());
-  MinefieldArtist::drawClickedMineCellSprite(data->clickedMine, config::getSettings().getCellPixelSize());
-  MinefieldArtist::drawMineCellRedXSprite(data->redXMine, config::getSettings().getCellPixelSize());
-
-  MinefieldArtist::drawNumericSprite(data->one, config::getSettings().getCellPixelSize(), 1, config::Colors::BLUE);
-  MinefieldArtist::drawNumericSprite(data->two, config::getSettings().getCellPixelSize(), 2, config::Colors::GREEN);
-  MinefieldArtist::drawNumericSprite(data->three, config::getSettings().getCellPixelSize(), 3, config::Colors::RED);
-  MinefieldArtist::drawNumericSprite(
-      data->four, config::getSettings().getCellPixelSize(), 4, config::Colors::DARK_BLUE);
-  MinefieldArtist::drawNumericSprite(data->five, config::getSettings().getCellPixelSize(), 5, config::Colors::DARK_RED);
-  MinefieldArtist::drawNumericSprite(data->six, config::getSettings().getCellPixelSize(), 6, config::Colors::TURQUOISE);
-  MinefieldArtist::drawNumericSprite(data->seven, config::getSettings().getCellPixelSize(), 7, config::Colors::PURPLE);
-  MinefieldArtist::drawNumericSprite(
-      data->eight, config::getSettings().getCellPixelSize(), 8, config::Colors::DARK_GREY);
-};
+  const int cellPixelSize = config::getSettings().getCellPixelSize();
+  std::ostringstream name;
+  name << "sprites-" << cellPixelSize << "-" << config::INFO_PANEL_BUTTONS_HEIGHT << "-" << std::hex
+       << std::setw(16) << std::setfill('0') << getCacheKey(cellPixelSize, config::INFO_PANEL_BUTTONS_HEIGHT) << ".bin";
+  return cacheDir / name.str();
+}
+
+bool Sprites::loadCache(const std::filesystem::path &path)
+{
+  auto file = MappedFile::open(path);
+  if (!file || file->getSize() != sizeof(CacheHeader) + numPixels * sizeof(uint32_t))
+  {
+    return false;
+  }
+
+  CacheHeader header;
+  std::memcpy(&header, file->getData(), sizeof(header));
+  const uint64_t key = getCacheKey(config::getSettings().getCellPixelSize(), config::INFO_PANEL_BUTTONS_HEIGHT);
+  if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.key != key ||
+      header.numPixels != numPixels)
+  {
+    return false;
+  }
+
+  cacheFile = std::move(file);
+  firstPixel = reinterpret_cast<const uint32_t *>(cacheFile->getData() + sizeof(CacheHeader));
+  return true;
+}
+
+void Sprites::drawSprites(ThreadPool *pool)
+{
+  buffer.resize(std::max<std::size_t>(numPixels * sizeof(uint32_t) / CACHE_LINE_SIZE, 1));
+  firstPixel = buffer.front().pixels;
+
+  if (!pool)
+  {
+    for (int i = 0; i < NUM_SPRITES; ++i)
+    {
+      drawSprite(static_cast<SpriteId>(i));
+    }
+    finishBaking();
+    return;
+  }
+
+  // every sprite starts on its own cache line, so the tasks never write to the same one
+  numUnbakedSprites = NUM_SPRITES;
+  for (int i = 0; i < NUM_SPRITES; ++i)
+  {
+    pool->submit(
+        [this, i]()
+        {
+          drawSprite(static_cast<SpriteId>(i));
+
+          {
+            std::lock_guard<std::mutex> lock(bakeMutex);
+            if (--numUnbakedSprites > 0)
+            {
+              return;
+            }
+          }
+          finishBaking();
+        });
+  }
+}
+
+void Sprites::drawSprite(const SpriteId id)
+{
+  // the artists draw into a vector of exactly one sprite, which is then copied into place
+  const int size = getSize(id);
+  std::vector<uint32_t> sprite(size * size, 0);
+  SPRITE_DRAWERS[toIndex(id)](sprite, size);
+  std::copy(sprite.begin(), sprite.end(), buffer.front().pixels + offsets[toIndex(id)]);
+}
+
+void Sprites::finishBaking()
+{
+  if (!cachePath.empty())
+  {
+    writeCache(cachePath);
+  }
+
+  std::lock_guard<std::mutex> lock(bakeMutex);
+  bakeTime = Clock::now() - bakeStart;
+  isBaked.store(true, std::memory_order_release);
+  bakeFinished.notify_all();
+}
 
-void Sprites::createIntToSpriteMap()
-{
-  data->intToSpriteMap = {
-      {0, data->empty},
-      {1, data->one},
-      {2, data->two},
-      {3, data->three},
-      {4, data->four},
-      {5, data->five},
-      {6, data->six},
-      {7, data->seven},
-      {8, data->eight},
-  };
-};
\ No newline at end of file
+void Sprites::waitUntilBaked()
+{
+  if (isBaked.load(std::memory_order_acquire))
+  {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(bakeMutex);
+  bakeFinished.wait(lock, [this] { return isBaked.load(std::memory_order_relaxed); });
+}
+
+void Sprites::writeCache(const std::filesystem::path &path) const
+{
+  // the cache only saves time, so any failure just leaves it for the next launch to try again
+  std::error_code error;
+  std::filesystem::create_directories(path.parent_path(), error);
+  if (error)
+  {
+    return;
+  }
+
+  CacheHeader header{};
+  std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+  header.key = getCacheKey(config::getSettings().getCellPixelSize(), config::INFO_PANEL_BUTTONS_HEIGHT);
+  header.numPixels = numPixels;
+
+  // written under a name of its own and renamed into place, so a reader never maps a half-written file and two
+  // launches baking at once don't interleave; the pid keeps the name unique across processes
+#ifdef _WIN32
+  const int pid = _getpid();
+#else
+  const int pid = static_cast<int>(getpid());
+#endif
+  auto tempPath = path;
+  tempPath += ".tmp" + std::to_string(pid) + "-" +
+              std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+  {
+    std::ofstream ofs(tempPath, std::ios::binary | std::ios::trunc);
+    ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    ofs.write(reinterpret_cast<const char *>(firstPixel), numPixels * sizeof(uint32_t));
+    if (!ofs.good())
+    {
+      ofs.close();
+      std::filesystem::remove(tempPath, error);
+      return;
+    }
+  }
+
+  std::filesystem::rename(tempPath, path, error);
+  if (error)
+  {
+    std::filesystem::remove(tempPath, error);
+  }
+}
@@ -0,0 +1,125 @@
+#include <ThreadPool.hpp>
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+ThreadPool::TaskGroup::TaskGroup(ThreadPool &p) : pool(p) {}
+
+ThreadPool::TaskGroup::~TaskGroup() { wait(); }
+
+void ThreadPool::TaskGroup::submit(std::function<void()> task)
+{
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    ++numUnfinishedTasks;
+  }
+  pool.push({std::move(task), this});
+}
+
+void ThreadPool::TaskGroup::wait()
+{
+  std::unique_lock<std::mutex> lock(pool.mutex);
+  while (numUnfinishedTasks > 0)
+  {
+    const auto queued =
+        std::find_if(pool.tasks.begin(), pool.tasks.end(), [this](const Task &task) { return task.group == this; });
+    if (queued == pool.tasks.end())
+    {
+      // the rest are running on workers
+      tasksFinished.wait(lock);
+      continue;
+    }
+
+    Task task = std::move(*queued);
+    pool.tasks.erase(queued);
+    lock.unlock();
+    task.run();
+    lock.lock();
+    pool.finish(task);
+  }
+}
+
+ThreadPool::ThreadPool(const int numThreads)
+{
+  const int count = numThreads > 0 ? numThreads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+  workers.reserve(count);
+  for (int i = 0; i < count; ++i)
+  {
+    workers.emplace_back(&ThreadPool::runWorker, this);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    isStopping = true;
+  }
+  taskAvailable.notify_all();
+
+  for (auto &worker : workers)
+  {
+    worker.join();
+  }
+}
+
+void ThreadPool::submit(std::function<void()> task) { push({std::move(task), nullptr}); }
+
+void ThreadPool::wait()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  tasksFinished.wait(lock, [this] { return numUnfinishedTasks == 0; });
+}
+
+// private
+
+void ThreadPool::push(Task task)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks.push_back(std::move(task));
+    ++numUnfinishedTasks;
+  }
+  taskAvailable.notify_one();
+}
+
+void ThreadPool::finish(const Task &task)
+{
+  if (task.group && --task.group->numUnfinishedTasks == 0)
+  {
+    task.group->tasksFinished.notify_all();
+  }
+  if (--numUnfinishedTasks == 0)
+  {
+    tasksFinished.notify_all();
+  }
+}
+
+void ThreadPool::runWorker()
+{
+  while (true)
+  {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      taskAvailable.wait(lock, [this] { return isStopping || !tasks.empty(); });
+
+      // queued tasks still run on shutdown so nobody is left waiting on them
+      if (tasks.empty())
+      {
+        return;
+      }
+
+      task = std::move(tasks.front());
+      tasks.pop_front();
+    }
+
+    task.run();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    finish(task);
+  }
+}
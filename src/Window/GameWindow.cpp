@@ -1,8 +1,11 @@
+#include <FrameTimer.hpp>
 #include <GameWindow.hpp>
 #include <HeaderArtist.hpp>
 #include <MinefieldArtist.hpp>
 #include <SDL2/SDL.h>
 #include <Sprites.hpp>
+#include <ThreadPool.hpp>
+#include <algorithm>
 #include <config.hpp>
 #include <cstdint>
 #include <cstring>
@@ -12,7 +15,7 @@
 #include <utils.hpp>
 #include <vector>
 
-GameWindow::GameWindow() : Window()
+GameWindow::GameWindow(ThreadPool &pool) : Window()
 {
   frameBuffer.resize(config::getSettings().getGameWindowWidth() * config::getSettings().getGameWindowHeight());
 
@@ -20,6 +23,12 @@ GameWindow::GameWindow() : Window()
       frameBuffer,
       config::getSettings().getGameWindowWidth(),
       config::getSettings().getGameWindowWidth() * config::getSettings().getGameWindowHeight());
+
+  numRasterThreads = std::max(config::getSettings().getRasterThreads(), 0);
+  if (numRasterThreads != 1)
+  {
+    rasterPool = &pool;
+  }
 }
 
 void GameWindow::init()
@@ -70,25 +79,66 @@ void GameWindow::init()
   windowID = SDL_GetWindowID(window.get());
 };
 
-void GameWindow::update(Minesweeper &gameState)
+bool GameWindow::update(Minesweeper &gameState)
 {
-  HeaderArtist::updateHeader(frameBuffer, config::getSettings().getGameWindowWidth(), gameState);
-  MinefieldArtist::updateMinefield(frameBuffer, config::getSettings().getCellPixelSize(), gameState);
+  HeaderArtist::updateHeader(frameBuffer, config::getSettings().getGameWindowWidth(), gameState, drawnHeader, damage);
 
-  void *pixels;
-  int pitch;
+  // the software minefield only redraws changed cells, so the ones under a closed overlay need an explicit redraw
+  if (isMinefieldStale || (wasFrameStatsShown && !showFrameStats))
+  {
+    gameState.markAllCellsDirty();
+    isMinefieldStale = false;
+  }
+  wasFrameStatsShown = showFrameStats;
+
+  bool isMinefieldChanged = false;
+  if (useSpriteAtlas)
+  {
+    // the atlas path draws every cell on every present, it only needs to know whether to present at all
+    isMinefieldChanged = gameState.getIsFullRedrawNeeded() || !gameState.getDirtyCells().empty();
+    gameState.clearDirtyCells();
+  }
+  else
+  {
+    MinefieldArtist::updateMinefield(
+        frameBuffer, config::getSettings().getCellPixelSize(), gameState, damage, rasterPool, numRasterThreads);
+  }
+
+  frameStatsPanel = {};
+  if (frameTimer && showFrameStats)
+  {
+    const auto numDamaged = damage.size();
+    HeaderArtist::drawFrameStats(
+        frameBuffer, config::getSettings().getGameWindowWidth(), frameTimer->getStats(), damage);
+    if (damage.size() > numDamaged)
+    {
+      frameStatsPanel = damage.back();
+    }
+  }
 
-  SDL_LockTexture(texture.get(), nullptr, &pixels, &pitch);
-  std::memcpy(
-      pixels,
-      frameBuffer.data(),
-      config::getSettings().getGameWindowWidth() * config::getSettings().getGameWindowHeight() * sizeof(uint32_t));
+  // the texture still holds the last frame, so an unchanged frame needs neither an upload nor a present
+  if (damage.empty() && !isInvalidated && !isMinefieldChanged)
+  {
+    return false;
+  }
 
-  SDL_UnlockTexture(texture.get());
+  uploadDamage();
   SDL_RenderCopy(renderer.get(), texture.get(), nullptr, nullptr);
-  SDL_RenderPresent(renderer.get());
+  if (useSpriteAtlas)
+  {
+    renderAtlasMinefield(gameState);
+  }
+  return true;
 };
 
+void GameWindow::setUseSpriteAtlas(const bool newVal)
+{
+  // the atlas path never draws the minefield into the frame buffer
+  isMinefieldStale = useSpriteAtlas && !newVal;
+  useSpriteAtlas = newVal;
+  isInvalidated = true;
+}
+
 void GameWindow::handleEvent(SDL_Event &event, Minesweeper &gameState, bool &isGameLoopRunning) const
 {
   const int cursorX = event.motion.x;
@@ -182,4 +232,77 @@ void GameWindow::handleEvent(SDL_Event &event, Minesweeper &gameState, bool &isG
       isGameLoopRunning = false;
     }
   }
-}
\ No newline at end of file
+}
+
+void GameWindow::uploadDamage()
+{
+  const int windowWidth = config::getSettings().getGameWindowWidth();
+  const int windowHeight = config::getSettings().getGameWindowHeight();
+  const int pitch = windowWidth * sizeof(uint32_t);
+
+  int damagedArea = 0;
+  for (const auto &rect : damage)
+  {
+    damagedArea += rect.w * rect.h;
+  }
+
+  // past about half the window, one contiguous upload is cheaper than many strided ones
+  if (isInvalidated || damagedArea > windowWidth * windowHeight / 2)
+  {
+    SDL_UpdateTexture(texture.get(), nullptr, frameBuffer.data(), pitch);
+  }
+  else
+  {
+    for (const auto &rect : damage)
+    {
+      const SDL_Rect sdlRect{rect.x, rect.y, rect.w, rect.h};
+      SDL_UpdateTexture(texture.get(), &sdlRect, frameBuffer.data() + rect.y * windowWidth + rect.x, pitch);
+    }
+  }
+
+  damage.clear();
+  isInvalidated = false;
+}
+
+void GameWindow::renderAtlasMinefield(const Minesweeper &gameState)
+{
+  if (!atlasTexture)
+  {
+    spriteAtlas = std::make_unique<SpriteAtlas>();
+    atlasTexture.reset(SDL_CreateTexture(
+        renderer.get(),
+        SDL_PIXELFORMAT_RGBA8888,
+        SDL_TEXTUREACCESS_STATIC,
+        spriteAtlas->getWidth(),
+        spriteAtlas->getHeight()));
+
+    if (!atlasTexture)
+    {
+      throw std::runtime_error(std::string("error creating sprite atlas texture: ") + SDL_GetError());
+    }
+
+    SDL_UpdateTexture(
+        atlasTexture.get(),
+        nullptr,
+        spriteAtlas->getPixels().data(),
+        spriteAtlas->getWidth() * sizeof(uint32_t));
+  }
+
+  // unscaled copies at integer positions, so even the software renderer reproduces the sprites bit for bit; SDL
+  // batches consecutive copies from one texture into a single draw
+  atlasCopies.clear();
+  spriteAtlas->appendMinefieldCopies(gameState, atlasCopies);
+  for (const auto &copy : atlasCopies)
+  {
+    const SDL_Rect source{copy.source.x, copy.source.y, copy.source.w, copy.source.h};
+    const SDL_Rect target{copy.target.x, copy.target.y, copy.target.w, copy.target.h};
+    SDL_RenderCopy(renderer.get(), atlasTexture.get(), &source, &target);
+  }
+
+  // the overlay lives in the frame buffer texture, which the cells were just drawn over
+  if (frameStatsPanel.w > 0)
+  {
+    const SDL_Rect panel{frameStatsPanel.x, frameStatsPanel.y, frameStatsPanel.w, frameStatsPanel.h};
+    SDL_RenderCopy(renderer.get(), texture.get(), &panel, &panel);
+  }
+}
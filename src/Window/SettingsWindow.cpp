@@ -2,6 +2,8 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include <SettingsWindow.hpp>
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <filesystem>
 #include <iostream>
@@ -56,7 +58,8 @@ void SettingsWindow::init()
     throw std::runtime_error(std::string("error creating window: ") + SDL_GetError());
   }
 
-  renderer.reset(SDL_CreateRenderer(window.get(), -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC));
+  // no vsync: only the game window's present may wait for vblank, or every frame with both open would wait twice
+  renderer.reset(SDL_CreateRenderer(window.get(), -1, SDL_RENDERER_ACCELERATED));
   if (renderer == nullptr)
   {
     throw std::runtime_error(std::string("error getting config renderer: ") + SDL_GetError());
@@ -65,7 +68,7 @@ void SettingsWindow::init()
   windowID = SDL_GetWindowID(window.get());
 }
 
-void SettingsWindow::update(Minesweeper &game)
+bool SettingsWindow::update(Minesweeper &game)
 {
   bool newShowConfig = game.getShowConfigButton();
 
@@ -80,17 +83,23 @@ void SettingsWindow::update(Minesweeper &game)
       }
 
       SDL_ShowWindow(window.get());
-      renderContent();
+      isInvalidated = true;
     }
     else
     {
       SDL_HideWindow(window.get());
     }
   }
-  else if (showConfigWindow)
+
+  // the menu only changes through its own events, which invalidate it
+  if (!showConfigWindow || !isInvalidated)
   {
-    renderContent();
+    return false;
   }
+
+  renderContent();
+  isInvalidated = false;
+  return true;
 }
 
 void SettingsWindow::handleEvent(SDL_Event &event)
@@ -101,6 +110,7 @@ void SettingsWindow::handleEvent(SDL_Event &event)
   switch (event.type)
   {
   case SDL_MOUSEBUTTONDOWN:
+    invalidate();
     for (auto *button : settingsMenuButtons.items())
     {
       if (utils::isPointInRect(cursorX, cursorY, button->rect))
@@ -127,6 +137,7 @@ void SettingsWindow::handleEvent(SDL_Event &event)
     break;
 
   case SDL_MOUSEBUTTONUP:
+    invalidate();
     for (auto *button : settingsMenuButtons.items())
     {
       if (button->isPressed && utils::isPointInRect(cursorX, cursorY, button->rect))
@@ -153,6 +164,7 @@ void SettingsWindow::handleEvent(SDL_Event &event)
     {
       return;
     }
+    invalidate();
 
     const auto keycode = event.key.keysym.sym;
     if (keycode == SDLK_BACKSPACE && value->size() > 0)
@@ -184,6 +196,11 @@ void SettingsWindow::createMenuItems()
       MENU_ITEM_X, FIRST_MENU_FIELD_Y + 2 * MENU_ITEM_VERT_SPACING, MENU_ITEM_WIDTH, MENU_ITEM_HEIGHT};
   settingsMenuFields.windowHeight.label = "Window Height";
   settingsMenuFields.windowHeight.value = std::to_string(config::getSettings().getGameWindowHeight());
+
+  settingsMenuFields.numMines.rect = SDL_Rect{
+      MENU_ITEM_X, FIRST_MENU_FIELD_Y + 3 * MENU_ITEM_VERT_SPACING, MENU_ITEM_WIDTH, MENU_ITEM_HEIGHT};
+  settingsMenuFields.numMines.label = "Mines";
+  settingsMenuFields.numMines.value = std::to_string(config::getSettings().getNumMines());
 }
 
 void SettingsWindow::createMenuButtons()
@@ -196,7 +213,20 @@ void SettingsWindow::createMenuButtons()
     const int cellSize = std::stoi(settingsMenuFields.cellSize.value);
     const int windowW = std::stoi(settingsMenuFields.windowWidth.value);
     const int windowH = std::stoi(settingsMenuFields.windowHeight.value);
-    config::getSettings().writeToFile(windowW, windowH, cellSize);
+    int numMines = std::stoi(settingsMenuFields.numMines.value);
+
+    // a mine count left alone while the grid changed size keeps its density rather than its number
+    const auto &settings = config::getSettings();
+    const int numGridCells = config::getNumGridCells(windowW, windowH, cellSize);
+    const int oldNumGridCells = settings.getGridWidth() * settings.getGridHeight();
+    if (numMines == settings.getNumMines() && numGridCells != oldNumGridCells && oldNumGridCells > 0)
+    {
+      numMines = static_cast<int>(std::lround(static_cast<double>(numMines) * numGridCells / oldNumGridCells));
+    }
+    numMines = std::clamp(numMines, 0, config::getMaxNumMines(numGridCells));
+
+    settingsMenuFields.numMines.value = std::to_string(numMines);
+    config::getSettings().writeToFile(windowW, windowH, cellSize, numMines);
   };
 
   settingsMenuButtons.restart.rect = SDL_Rect{
@@ -215,6 +245,8 @@ void SettingsWindow::createMenuButtons()
     settingsMenuFields.cellSize.value = std::to_string(config::DEFAULT_CELL_PIXEL_SIZE);
     settingsMenuFields.windowWidth.value = std::to_string(defaultWidth);
     settingsMenuFields.windowHeight.value = std::to_string(defaultHeight);
+    settingsMenuFields.numMines.value =
+        std::to_string(config::getDefaultNumMines(defaultWidth, defaultHeight, config::DEFAULT_CELL_PIXEL_SIZE));
   };
 
   settingsMenuButtons.cancel.rect = SDL_Rect{
@@ -243,8 +275,6 @@ void SettingsWindow::renderContent()
   {
     renderTextBox(button->label, colors.black, utils::hexToRgba(button->bgColorHex), button->rect);
   }
-
-  SDL_RenderPresent(renderer.get());
 }
 
 void SettingsWindow::renderMenuItem(const SettingsField &menuItem)
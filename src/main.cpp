@@ -1,18 +1,37 @@
 #include <GameLoop.hpp>
 #include <Minesweeper.hpp>
+#include <NoGuessGenerator.hpp>
 #include <Renderer.hpp>
 #include <Sprites.hpp>
+#include <ThreadPool.hpp>
+#include <chrono>
+#include <config.hpp>
 
 int main(int, char **)
 {
+  const auto startTime = std::chrono::steady_clock::now();
+
   if (!Renderer::initSDL())
   {
     return 1;
   };
 
-  Minesweeper game;
-  Renderer renderer;
-  GameLoop gameLoop(game, renderer);
+  Minesweeper game(
+      config::getSettings().getGridWidth(), config::getSettings().getGridHeight(), config::getSettings().getNumMines());
+
+  ThreadPool threadPool;
+  NoGuessGenerator noGuessGenerator(threadPool);
+  if (config::getSettings().getNoGuess())
+  {
+    game.setNoGuessGenerator(&noGuessGenerator);
+  }
+
+  // the sprites only need the settings, so they are drawn on the pool while SDL creates the windows; the game loop
+  // waits for them before its first frame
+  Sprites::startBaking(threadPool);
+
+  Renderer renderer(threadPool);
+  GameLoop gameLoop(game, renderer, startTime);
   gameLoop.run();
 
   return 0;
@@ -0,0 +1,473 @@
+// minesweeper-sim: plays games headlessly through the same Minesweeper click API the GUI uses and reports win rate,
+// throughput and where the time went. Games are sharded across a thread pool, one seed per game.
+
+#include <Minesweeper.hpp>
+#include <ProbabilityEngine.hpp>
+#include <Random.hpp>
+#include <Solver.hpp>
+#include <ThreadPool.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+enum class Policy
+{
+  RANDOM,
+  SOLVER,
+  GREEDY,
+};
+
+enum class Format
+{
+  CSV,
+  JSON,
+};
+
+struct Options
+{
+  int gridWidth = 30;
+  int gridHeight = 16;
+  int numMines = 99;
+  double density = -1;
+  uint64_t firstSeed = 0;
+  uint64_t lastSeed = 10000;
+  Policy policy = Policy::SOLVER;
+  int numThreads = 0;
+  Format format = Format::CSV;
+};
+
+// per-phase wall time, summed over every worker
+struct Stats
+{
+  int64_t numGames = 0;
+  int64_t numWins = 0;
+  int64_t numGuesses = 0;
+  double generateSeconds = 0;
+  double playSeconds = 0;
+  double solveSeconds = 0;
+  double guessSeconds = 0;
+
+  void add(const Stats &other)
+  {
+    numGames += other.numGames;
+    numWins += other.numWins;
+    numGuesses += other.numGuesses;
+    generateSeconds += other.generateSeconds;
+    playSeconds += other.playSeconds;
+    solveSeconds += other.solveSeconds;
+    guessSeconds += other.guessSeconds;
+  }
+};
+
+constexpr int GAMES_PER_BATCH = 64;
+constexpr std::chrono::milliseconds GREEDY_TIME_BUDGET{50};
+
+const char *USAGE = "usage: minesweeper-sim [options]\n"
+                    "  --width N           grid width (30)\n"
+                    "  --height N          grid height (16)\n"
+                    "  --mines N           number of mines (99)\n"
+                    "  --density F         mines as a fraction of cells, instead of --mines\n"
+                    "  --seeds FIRST:LAST  play one game per seed in [FIRST, LAST) (0:10000)\n"
+                    "  --policy P          random | solver | greedy (solver)\n"
+                    "  --threads N         worker threads, 0 for one per core (0)\n"
+                    "  --format F          csv | json (csv)\n";
+
+const char *toString(const Policy policy)
+{
+  switch (policy)
+  {
+  case Policy::RANDOM:
+    return "random";
+  case Policy::SOLVER:
+    return "solver";
+  case Policy::GREEDY:
+    return "greedy";
+  }
+  return "";
+}
+
+Options parseOptions(const int argc, char **argv)
+{
+  Options options;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string key = argv[i];
+    if (key == "--help" || key == "-h")
+    {
+      std::cout << USAGE;
+      std::exit(0);
+    }
+    if (i + 1 >= argc)
+    {
+      throw std::runtime_error("missing value for " + key);
+    }
+    const std::string value = argv[++i];
+
+    if (key == "--width")
+    {
+      options.gridWidth = std::stoi(value);
+    }
+    else if (key == "--height")
+    {
+      options.gridHeight = std::stoi(value);
+    }
+    else if (key == "--mines")
+    {
+      options.numMines = std::stoi(value);
+    }
+    else if (key == "--density")
+    {
+      options.density = std::stod(value);
+    }
+    else if (key == "--seeds")
+    {
+      const auto delimPos = value.find(':');
+      if (delimPos == std::string::npos)
+      {
+        throw std::runtime_error("--seeds expects FIRST:LAST");
+      }
+      options.firstSeed = std::stoull(value.substr(0, delimPos));
+      options.lastSeed = std::stoull(value.substr(delimPos + 1));
+    }
+    else if (key == "--policy")
+    {
+      if (value == "random")
+      {
+        options.policy = Policy::RANDOM;
+      }
+      else if (value == "solver")
+      {
+        options.policy = Policy::SOLVER;
+      }
+      else if (value == "greedy")
+      {
+        options.policy = Policy::GREEDY;
+      }
+      else
+      {
+        throw std::runtime_error("unknown policy " + value);
+      }
+    }
+    else if (key == "--threads")
+    {
+      options.numThreads = std::stoi(value);
+    }
+    else if (key == "--format")
+    {
+      if (value != "csv" && value != "json")
+      {
+        throw std::runtime_error("unknown format " + value);
+      }
+      options.format = value == "csv" ? Format::CSV : Format::JSON;
+    }
+    else
+    {
+      throw std::runtime_error("unknown option " + key);
+    }
+  }
+
+  if (options.gridWidth < 1 || options.gridHeight < 1)
+  {
+    throw std::runtime_error("grid must be at least 1x1");
+  }
+  if (options.density >= 0)
+  {
+    options.numMines = static_cast<int>(std::lround(options.density * options.gridWidth * options.gridHeight));
+  }
+  if (options.lastSeed < options.firstSeed)
+  {
+    throw std::runtime_error("--seeds range is empty");
+  }
+
+  return options;
+}
+
+// one worker's game state, reused across its games
+class Player
+{
+public:
+  Player(const Options &o, Stats &s)
+      : options(o), stats(s), game(o.gridWidth, o.gridHeight, o.numMines), solver(game), engine(game, enginePool)
+  {
+  }
+
+  void play(const uint64_t seed)
+  {
+    using Clock = std::chrono::steady_clock;
+
+    game.reset(seed);
+    solver.reset();
+    random.reseed(seed ^ 0x5bd1e9955bd1e995);
+    numHiddenCells = options.gridWidth * options.gridHeight;
+    numFlaggedSolverMines = 0;
+
+    // the player's guessing order, shuffled once so each guess is amortised O(1)
+    guessOrder.resize(numHiddenCells);
+    for (int i = 0; i < numHiddenCells; ++i)
+    {
+      guessOrder[i] = i;
+    }
+    for (int i = numHiddenCells - 1; i > 0; --i)
+    {
+      std::swap(guessOrder[i], guessOrder[random.nextBelow(i + 1)]);
+    }
+    nextGuess = 0;
+
+    auto start = Clock::now();
+    game.handleLeftClick(options.gridHeight / 2, options.gridWidth / 2);
+    stats.generateSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+    observe();
+
+    while (!game.getIsGameOver())
+    {
+      // once only mines are left hidden, flagging them is all that's left
+      if (numHiddenCells == game.getNumMines())
+      {
+        flagRemainingCells();
+        break;
+      }
+
+      if (options.policy != Policy::RANDOM && numFlaggedSolverMines < solver.getMineCells().size())
+      {
+        flagAndChord(solver.getMineCells()[numFlaggedSolverMines++]);
+      }
+      else if (options.policy != Policy::RANDOM && !solver.getSafeCells().empty())
+      {
+        click(solver.getSafeCells().back());
+      }
+      else
+      {
+        start = Clock::now();
+        const int index = chooseGuess();
+        stats.guessSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+        ++stats.numGuesses;
+        click(index);
+      }
+    }
+
+    ++stats.numGames;
+    stats.numWins += game.getIsGameWon();
+  }
+
+private:
+  const Options &options;
+  Stats &stats;
+  Minesweeper game;
+  Solver solver;
+  ThreadPool enginePool{1};
+  ProbabilityEngine engine;
+  Random random;
+  std::vector<int> guessOrder;
+  std::size_t nextGuess = 0;
+  std::size_t numFlaggedSolverMines = 0;
+  int numHiddenCells = 0;
+
+  void click(const int index)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    game.handleLeftClick(index / options.gridWidth, index % options.gridWidth);
+    game.checkForGameWon();
+    stats.playSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    observe();
+  }
+
+  // flags a deduced mine, then chords the numbers around it, which is how a person clears what the flag settles
+  void flagAndChord(const int index)
+  {
+    const int row = index / options.gridWidth;
+    const int col = index % options.gridWidth;
+
+    auto start = std::chrono::steady_clock::now();
+    if (!game.getMinefield()[index].getIsFlagged())
+    {
+      game.handleRightClick(row, col);
+    }
+    stats.playSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (int dRow = -1; dRow <= 1; ++dRow)
+    {
+      for (int dCol = -1; dCol <= 1; ++dCol)
+      {
+        const int r = row + dRow;
+        const int c = col + dCol;
+        if (r < 0 || c < 0 || r >= options.gridHeight || c >= options.gridWidth ||
+            game.getMinefield()[r * options.gridWidth + c].getIsHidden())
+        {
+          continue;
+        }
+
+        start = std::chrono::steady_clock::now();
+        game.handleMiddleClick(r, c);
+        game.checkForGameWon();
+        stats.playSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        observe();
+      }
+    }
+  }
+
+  void flagRemainingCells()
+  {
+    const auto start = std::chrono::steady_clock::now();
+    const auto &minefield = game.getMinefield();
+    for (int i = 0; i < static_cast<int>(minefield.size()); ++i)
+    {
+      if (minefield[i].getIsHidden() && !minefield[i].getIsFlagged())
+      {
+        game.handleRightClick(i / options.gridWidth, i % options.gridWidth);
+      }
+    }
+    game.checkForGameWon();
+    stats.playSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  void observe()
+  {
+    if (!game.getIsGameOver())
+    {
+      numHiddenCells -= static_cast<int>(game.getRevealedCells().size());
+    }
+
+    if (options.policy != Policy::RANDOM)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      solver.update(game.getRevealedCells());
+      stats.solveSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+  }
+
+  int chooseGuess()
+  {
+    const auto &minefield = game.getMinefield();
+    const auto isCandidate = [&](const int index)
+    { return minefield[index].getIsHidden() && !minefield[index].getIsFlagged() && !solver.getIsKnownMine(index); };
+
+    if (options.policy == Policy::GREEDY)
+    {
+      engine.compute(GREEDY_TIME_BUDGET);
+      const auto &probabilities = engine.getMineProbabilities();
+
+      int best = -1;
+      for (int i = 0; i < static_cast<int>(minefield.size()); ++i)
+      {
+        if (isCandidate(i) && (best < 0 || probabilities[i] < probabilities[best]))
+        {
+          best = i;
+        }
+      }
+      return best;
+    }
+
+    while (!isCandidate(guessOrder[nextGuess]))
+    {
+      ++nextGuess;
+    }
+    return guessOrder[nextGuess];
+  }
+};
+
+// numMines is what the games actually placed, which --mines and --density can overshoot
+void printStats(
+    const Options &options,
+    const Stats &stats,
+    const int numMines,
+    const int numThreads,
+    const double seconds)
+{
+  const double winRate = stats.numGames > 0 ? static_cast<double>(stats.numWins) / stats.numGames : 0;
+  const double gamesPerSecond = seconds > 0 ? stats.numGames / seconds : 0;
+
+  if (options.format == Format::CSV)
+  {
+    std::cout << "width,height,mines,policy,threads,first_seed,games,wins,win_rate,guesses,seconds,games_per_sec,"
+                 "generate_sec,play_sec,solve_sec,guess_sec\n";
+    std::cout << options.gridWidth << "," << options.gridHeight << "," << numMines << ","
+              << toString(options.policy) << "," << numThreads << "," << options.firstSeed << "," << stats.numGames
+              << "," << stats.numWins << "," << winRate << "," << stats.numGuesses << "," << seconds << ","
+              << gamesPerSecond << "," << stats.generateSeconds << "," << stats.playSeconds << ","
+              << stats.solveSeconds << "," << stats.guessSeconds << "\n";
+    return;
+  }
+
+  std::cout << "{\n"
+            << "  \"width\": " << options.gridWidth << ",\n"
+            << "  \"height\": " << options.gridHeight << ",\n"
+            << "  \"mines\": " << numMines << ",\n"
+            << "  \"policy\": \"" << toString(options.policy) << "\",\n"
+            << "  \"threads\": " << numThreads << ",\n"
+            << "  \"first_seed\": " << options.firstSeed << ",\n"
+            << "  \"games\": " << stats.numGames << ",\n"
+            << "  \"wins\": " << stats.numWins << ",\n"
+            << "  \"win_rate\": " << winRate << ",\n"
+            << "  \"guesses\": " << stats.numGuesses << ",\n"
+            << "  \"seconds\": " << seconds << ",\n"
+            << "  \"games_per_sec\": " << gamesPerSecond << ",\n"
+            << "  \"phase_sec\": {\n"
+            << "    \"generate\": " << stats.generateSeconds << ",\n"
+            << "    \"play\": " << stats.playSeconds << ",\n"
+            << "    \"solve\": " << stats.solveSeconds << ",\n"
+            << "    \"guess\": " << stats.guessSeconds << "\n"
+            << "  }\n"
+            << "}\n";
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+  Options options;
+  try
+  {
+    options = parseOptions(argc, argv);
+  }
+  catch (const std::exception &e)
+  {
+    std::cerr << "minesweeper-sim: " << e.what() << "\n" << USAGE;
+    return 1;
+  }
+
+  ThreadPool pool(options.numThreads);
+  std::atomic<uint64_t> nextSeed{options.firstSeed};
+  std::mutex statsMutex;
+  Stats total;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < pool.getNumThreads(); ++i)
+  {
+    pool.submit(
+        [&]
+        {
+          Stats stats;
+          Player player(options, stats);
+
+          // seeds are handed out in batches so workers don't contend on the counter
+          for (uint64_t first = nextSeed.fetch_add(GAMES_PER_BATCH); first < options.lastSeed;
+               first = nextSeed.fetch_add(GAMES_PER_BATCH))
+          {
+            for (uint64_t seed = first; seed < std::min(first + GAMES_PER_BATCH, options.lastSeed); ++seed)
+            {
+              player.play(seed);
+            }
+          }
+
+          std::lock_guard<std::mutex> lock(statsMutex);
+          total.add(stats);
+        });
+  }
+  pool.wait();
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  // Minesweeper clamps the mine count to the grid, keeping the first click's neighbourhood clear
+  const int numMines = Minesweeper(options.gridWidth, options.gridHeight, options.numMines).getNumMines();
+  printStats(options, total, numMines, pool.getNumThreads(), seconds);
+  return 0;
+}